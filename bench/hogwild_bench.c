@@ -0,0 +1,205 @@
+// Hogwild training benchmark and convergence check (native build)
+// Build and run from the project root:
+//   mkdir -p build
+//   cc -O3 -pthread -DANN_ENABLE_THREADS src/c/ann_wrapper.c src/asm/ann_simd_x86.c bench/hogwild_bench.c -o build/hogwild_bench -lm
+//   ./build/hogwild_bench [n_rows] [max_threads]
+// Part 1 trains on each bundled example CSV with train_ann_v2 and with
+// train_ann_hogwild at 1, 2 and 4 threads, and fails if Hogwild ends with a
+// clearly worse loss. Part 2 measures training throughput (samples/s) on a
+// synthetic dataset against single-threaded train_ann_v2.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern float train_ann_v2(float* inputs, float* outputs, int n_rows, int n_inputs,
+                          int n_hidden, int activation_type, float* loss_history);
+extern float train_ann_hogwild(float* inputs, float* outputs, int n_rows, int n_inputs,
+                               int n_hidden, int activation_type, float learning_rate, int epochs,
+                               int n_threads, float* loss_history);
+
+#define MAX_ROWS 1000
+#define MAX_COLS 11
+#define MAX_CELL 64
+#define EPOCHS 300
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int compare_strings(const void* a, const void* b) {
+    return strcmp((const char*)a, (const char*)b);
+}
+
+// Load a CSV the way the web app encodes it: numeric columns as-is,
+// categorical columns as the index of the value in sorted order; then
+// min-max normalize every column to [0, 1]. Last column is the target.
+static int load_csv(const char* path, float* inputs, float* outputs, int* n_inputs) {
+    static char cells[MAX_ROWS][MAX_COLS][MAX_CELL];
+    char line[1024];
+    int n_rows = 0;
+    int n_cols = 0;
+    
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    fgets(line, sizeof(line), file); // Header
+    while (n_rows < MAX_ROWS && fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') {
+            continue;
+        }
+        int col = 0;
+        for (char* tok = strtok(line, ","); tok != NULL && col < MAX_COLS; tok = strtok(NULL, ",")) {
+            snprintf(cells[n_rows][col++], MAX_CELL, "%s", tok);
+        }
+        n_cols = col;
+        n_rows++;
+    }
+    fclose(file);
+    
+    static float values[MAX_ROWS][MAX_COLS];
+    for (int c = 0; c < n_cols; c++) {
+        int numeric = 1;
+        for (int r = 0; r < n_rows && numeric; r++) {
+            char* end;
+            strtof(cells[r][c], &end);
+            numeric = (end != cells[r][c] && *end == '\0');
+        }
+        if (numeric) {
+            for (int r = 0; r < n_rows; r++) {
+                values[r][c] = strtof(cells[r][c], NULL);
+            }
+        } else {
+            static char sorted[MAX_ROWS][MAX_CELL];
+            for (int r = 0; r < n_rows; r++) {
+                memcpy(sorted[r], cells[r][c], MAX_CELL);
+            }
+            qsort(sorted, n_rows, MAX_CELL, compare_strings);
+            for (int r = 0; r < n_rows; r++) {
+                int code = 0;
+                for (int u = 0; u < n_rows && strcmp(sorted[u], cells[r][c]) != 0; u++) {
+                    if (u == 0 || strcmp(sorted[u], sorted[u - 1]) != 0) {
+                        code++;
+                    }
+                }
+                values[r][c] = (float)(code > 0 ? code - 1 : 0);
+            }
+        }
+        
+        float lo = values[0][c], hi = values[0][c];
+        for (int r = 1; r < n_rows; r++) {
+            lo = values[r][c] < lo ? values[r][c] : lo;
+            hi = values[r][c] > hi ? values[r][c] : hi;
+        }
+        for (int r = 0; r < n_rows; r++) {
+            values[r][c] = (hi > lo) ? (values[r][c] - lo) / (hi - lo) : 0.0f;
+        }
+    }
+    
+    *n_inputs = n_cols - 1;
+    for (int r = 0; r < n_rows; r++) {
+        for (int c = 0; c < n_cols - 1; c++) {
+            inputs[r * (n_cols - 1) + c] = values[r][c];
+        }
+        outputs[r] = values[r][n_cols - 1];
+    }
+    return n_rows;
+}
+
+static int check_convergence(void) {
+    static const char* paths[] = {
+        "src/data/example_numeric.csv",
+        "src/data/example_categorical.csv",
+        "src/data/example_mixed.csv",
+    };
+    static const int thread_counts[] = {1, 2, 4};
+    static float inputs[MAX_ROWS * MAX_COLS];
+    static float outputs[MAX_ROWS];
+    int failures = 0;
+    
+    printf("Convergence (final MSE after %d epochs, 6 hidden, sigmoid)\n", EPOCHS);
+    for (int f = 0; f < 3; f++) {
+        int n_inputs;
+        int n_rows = load_csv(paths[f], inputs, outputs, &n_inputs);
+        if (n_rows <= 0) {
+            printf("  %-34s could not be read (run from the project root)\n", paths[f]);
+            failures++;
+            continue;
+        }
+        
+        float reference = train_ann_v2(inputs, outputs, n_rows, n_inputs, 6, 0, NULL);
+        printf("  %-34s v2 %.5f", paths[f], reference);
+        for (int i = 0; i < 3; i++) {
+            float loss = train_ann_hogwild(inputs, outputs, n_rows, n_inputs, 6, 0, 0.01f, EPOCHS,
+                                           thread_counts[i], NULL);
+            // Same SGD, different update interleaving: allow modest drift
+            int ok = loss >= 0.0f && loss <= reference * 1.5f + 0.01f;
+            failures += !ok;
+            printf("  hogwild x%d %.5f%s", thread_counts[i], loss, ok ? "" : " (FAIL)");
+        }
+        printf("\n");
+    }
+    return failures;
+}
+
+static void measure_throughput(int n_rows, int max_threads) {
+    const int n_inputs = 8;
+    const int n_hidden = 20;
+    float* inputs = (float*)malloc((size_t)n_rows * n_inputs * sizeof(float));
+    float* outputs = (float*)malloc((size_t)n_rows * sizeof(float));
+    if (inputs == NULL || outputs == NULL) {
+        printf("Out of memory\n");
+        exit(1);
+    }
+    
+    unsigned int state = 7;
+    for (int i = 0; i < n_rows * n_inputs; i++) {
+        state = state * 1664525u + 1013904223u;
+        inputs[i] = (state >> 8) / 16777216.0f;
+    }
+    for (int r = 0; r < n_rows; r++) {
+        float* x = &inputs[r * n_inputs];
+        outputs[r] = (2.0f * x[0] - x[1] + 0.5f * x[2] * x[3] - 0.3f * x[7] > 0.4f) ? 1.0f : 0.0f;
+    }
+    
+    double samples = (double)n_rows * EPOCHS;
+    printf("\nThroughput (%d rows x %d inputs, %d hidden, relu, %d epochs)\n",
+           n_rows, n_inputs, n_hidden, EPOCHS);
+    
+    double start = now_seconds();
+    float loss = train_ann_v2(inputs, outputs, n_rows, n_inputs, n_hidden, 1, NULL);
+    double baseline = now_seconds() - start;
+    printf("  %-18s %8.3f s %12.0f samples/s  loss %.5f\n", "train_ann_v2", baseline,
+           samples / baseline, loss);
+    
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        start = now_seconds();
+        loss = train_ann_hogwild(inputs, outputs, n_rows, n_inputs, n_hidden, 1, 0.01f, EPOCHS, threads, NULL);
+        double elapsed = now_seconds() - start;
+        char label[32];
+        snprintf(label, sizeof(label), "hogwild x%d", threads);
+        printf("  %-18s %8.3f s %12.0f samples/s  loss %.5f  speedup %.2fx\n", label, elapsed,
+               samples / elapsed, loss, baseline / elapsed);
+    }
+    
+    free(inputs);
+    free(outputs);
+}
+
+int main(int argc, char** argv) {
+    int n_rows = (argc > 1) ? atoi(argv[1]) : 100000;
+    int max_threads = (argc > 2) ? atoi(argv[2]) : 32;
+    
+    int failures = check_convergence();
+    measure_throughput(n_rows, max_threads);
+    
+    if (failures > 0) {
+        printf("\n%d convergence check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
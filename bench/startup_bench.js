@@ -0,0 +1,150 @@
+// Startup benchmark: full module (build.sh) vs inference-only module
+// (build_inference.sh). Run from the project root after both builds:
+//   ./build.sh && ./build_inference.sh
+//   node bench/startup_bench.js [runs]
+// Reports the .wasm download size (raw and gzip), WebAssembly.compile time
+// and the time for the Emscripten factory to produce a ready module (median
+// of `runs`, default 20). It then trains a small model in the full module,
+// loads its parameters into the inference module and checks that both give
+// the same predictions.
+const fs = require('fs');
+const path = require('path');
+const zlib = require('zlib');
+const { performance } = require('perf_hooks');
+
+const BUILD_DIR = path.join(__dirname, '..', 'build');
+const TARGETS = [
+    { label: 'full', name: 'neurobrain' },
+    { label: 'inference', name: 'neurobrain-infer' }
+];
+
+function median(values) {
+    const sorted = [...values].sort((a, b) => a - b);
+    const mid = Math.floor(sorted.length / 2);
+    return sorted.length % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+function formatKB(bytes) {
+    return `${(bytes / 1024).toFixed(1)} KB`;
+}
+
+async function measureTarget(target, runs) {
+    const jsPath = path.join(BUILD_DIR, `${target.name}.js`);
+    const wasmPath = path.join(BUILD_DIR, `${target.name}.wasm`);
+    if (!fs.existsSync(jsPath) || !fs.existsSync(wasmPath)) {
+        throw new Error(`${target.name}.js/.wasm not found in build/ (run the ${target.label} build first)`);
+    }
+
+    const wasmBytes = fs.readFileSync(wasmPath);
+    const factory = require(jsPath);
+
+    // Warm-up so file system caches and the JIT do not skew the first run
+    await WebAssembly.compile(wasmBytes);
+    await factory();
+
+    const compileTimes = [];
+    const startupTimes = [];
+    for (let i = 0; i < runs; i++) {
+        let start = performance.now();
+        await WebAssembly.compile(wasmBytes);
+        compileTimes.push(performance.now() - start);
+
+        start = performance.now();
+        await factory();
+        startupTimes.push(performance.now() - start);
+    }
+
+    return {
+        label: target.label,
+        factory,
+        jsBytes: fs.statSync(jsPath).size,
+        wasmBytes: wasmBytes.length,
+        wasmGzipBytes: zlib.gzipSync(wasmBytes, { level: 9 }).length,
+        compileMs: median(compileTimes),
+        startupMs: median(startupTimes)
+    };
+}
+
+// Train on a small synthetic dataset in the full module, then score the same
+// rows with the full module and with the parameters loaded into the
+// inference module. Returns the largest absolute prediction difference.
+async function checkModelTransfer(fullFactory, inferFactory) {
+    const n_rows = 200, n_inputs = 4, n_hidden = 8, activation = 1;
+    const full = await fullFactory();
+    const infer = await inferFactory();
+
+    const inputs = new Float32Array(n_rows * n_inputs);
+    const outputs = new Float32Array(n_rows);
+    for (let r = 0; r < n_rows; r++) {
+        for (let i = 0; i < n_inputs; i++) {
+            inputs[r * n_inputs + i] = Math.random();
+        }
+        outputs[r] = inputs[r * n_inputs] + inputs[r * n_inputs + 1] > 1.0 ? 1 : 0;
+    }
+
+    // Train the default network of the full module and extract its parameters
+    const inPtr = full._malloc(inputs.length * 4);
+    const outPtr = full._malloc(outputs.length * 4);
+    const predPtr = full._malloc(n_rows * 4);
+    full.HEAPF32.set(inputs, inPtr / 4);
+    full.HEAPF32.set(outputs, outPtr / 4);
+    full._train_ann_v2(inPtr, outPtr, n_rows, n_inputs, n_hidden, activation, 0);
+    full._run_ann_batch(0, inPtr, n_rows, predPtr);
+    const n_params = full._get_network_params(0, 0);
+    const paramsPtr = full._malloc(n_params * 4);
+    full._get_network_params(0, paramsPtr);
+    const params = full.HEAPF32.slice(paramsPtr / 4, paramsPtr / 4 + n_params);
+    const fullPredictions = full.HEAPF32.slice(predPtr / 4, predPtr / 4 + n_rows);
+
+    // Load them into a handle of the inference module and score again
+    const handle = infer._create_network();
+    const iParamsPtr = infer._malloc(n_params * 4);
+    const iInPtr = infer._malloc(inputs.length * 4);
+    const iPredPtr = infer._malloc(n_rows * 4);
+    infer.HEAPF32.set(params, iParamsPtr / 4);
+    infer.HEAPF32.set(inputs, iInPtr / 4);
+    const loadStatus = infer._load_network_params(handle, n_inputs, n_hidden, activation, iParamsPtr);
+    if (loadStatus !== 0) {
+        throw new Error(`load_network_params failed with error code: ${loadStatus}`);
+    }
+    infer._run_ann_batch(handle, iInPtr, n_rows, iPredPtr);
+    const inferPredictions = infer.HEAPF32.subarray(iPredPtr / 4, iPredPtr / 4 + n_rows);
+
+    let maxDiff = 0;
+    for (let r = 0; r < n_rows; r++) {
+        maxDiff = Math.max(maxDiff, Math.abs(fullPredictions[r] - inferPredictions[r]));
+    }
+    infer._destroy_network(handle);
+    return maxDiff;
+}
+
+async function main() {
+    const runs = parseInt(process.argv[2], 10) || 20;
+    const results = [];
+    for (const target of TARGETS) {
+        results.push(await measureTarget(target, runs));
+    }
+
+    console.log(`Startup benchmark (median of ${runs} runs, Node ${process.version})`);
+    console.log('module      wasm        wasm.gz     js glue     compile    ready');
+    for (const r of results) {
+        console.log(`${r.label.padEnd(12)}${formatKB(r.wasmBytes).padEnd(12)}${formatKB(r.wasmGzipBytes).padEnd(12)}` +
+                    `${formatKB(r.jsBytes).padEnd(12)}${r.compileMs.toFixed(2).padStart(6)} ms  ${r.startupMs.toFixed(2).padStart(6)} ms`);
+    }
+
+    const [full, infer] = results;
+    console.log(`inference/full: wasm.gz ${(infer.wasmGzipBytes / full.wasmGzipBytes * 100).toFixed(0)}%, ` +
+                `ready ${(infer.startupMs / full.startupMs * 100).toFixed(0)}%`);
+
+    const maxDiff = await checkModelTransfer(full.factory, infer.factory);
+    console.log(`Model transfer check: max |full - inference| = ${maxDiff.toExponential(2)}`);
+    if (maxDiff > 1e-6) {
+        console.error('FAIL: inference module predictions differ from the full module');
+        process.exit(1);
+    }
+}
+
+main().catch((error) => {
+    console.error(error.message);
+    process.exit(1);
+});
@@ -16,10 +16,10 @@ fi
 mkdir -p build
 
 # Compile WASM SIMD and C to WebAssembly
-emcc src/c/ann_wrapper.c src/asm/ann_simd.c \
+emcc src/c/ann_wrapper.c src/c/csv_parser.c src/asm/ann_simd.c \
   -o build/neurobrain.js \
-  -s EXPORTED_FUNCTIONS='["_train_ann","_train_ann_v2","_run_ann","_get_weights","_malloc","_free"]' \
-  -s EXPORTED_RUNTIME_METHODS='["cwrap","HEAPF32"]' \
+  -s EXPORTED_FUNCTIONS='["_train_ann","_train_ann_v2","_train_ann_v3","_train_ann_v4","_train_ann_layers","_train_ann_classifier","_train_ann_epochs","_train_ann_step","_train_ann_parallel","_train_ann_hogwild","_create_network","_destroy_network","_train_network","_train_network_hogwild","_train_network_layers","_train_network_classifier","_train_network_epochs","_train_network_step","_set_network_warm_start","_train_network_begin","_train_network_run_epochs","_train_network_run_for_ms","_train_network_finish","_run_network","_get_network_weights","_load_network_params","_get_network_params","_get_network_layers","_save_model","_load_model","_load_model_view","_load_ann_model","_run_ann_batch","_classify_batch","_create_inference_context","_destroy_inference_context","_run_network_ctx","_export_network_c","_get_alloc_count","_run_ann","_get_weights","_csv_create","_csv_feed","_csv_finish","_csv_parse","_csv_table_values","_csv_table_rows","_csv_table_cols","_csv_table_error","_csv_table_error_line","_csv_table_error_col","_csv_table_split_xy","_csv_table_free","_compute_column_stats","_normalize_columns","_set_network_normalization","_get_network_normalization","_malloc","_free"]' \
+  -s EXPORTED_RUNTIME_METHODS='["cwrap","HEAPF32","HEAPU8","UTF8ToString"]' \
   -s MODULARIZE=1 \
   -s EXPORT_NAME='Module' \
   -s WASM=1 \
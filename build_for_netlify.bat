@@ -25,6 +25,8 @@ copy src\web\style.css dist\
 copy src\web\app.js dist\
 copy src\web\encoder.js dist\
 copy src\web\modal-manager.js dist\
+copy src\web\train_stream.js dist\
+copy src\web\train_worker.js dist\
 
 REM Copy WASM files
 echo Copying WASM files...
@@ -0,0 +1,50 @@
+#!/bin/bash
+# Inference-only WebAssembly build for Frankenstein Neural Web
+# Compiles ann_wrapper.c with -DANN_INFERENCE_ONLY, which drops training,
+# the optimizers and the model compiler, leaving model loading
+# (load_network_params) and the forward-pass kernels. Intended for embedded
+# prediction widgets that score with models trained elsewhere.
+# -Oz also runs Binaryen's wasm-opt at -Oz on the output module.
+
+echo "Building Frankenstein Neural Web (inference only)..."
+
+# Check if Emscripten is installed
+if ! command -v emcc &> /dev/null
+then
+    echo "Error: Emscripten (emcc) not found. Please install Emscripten first."
+    echo "Visit: https://emscripten.org/docs/getting_started/downloads.html"
+    exit 1
+fi
+
+# Create build directory if it doesn't exist
+mkdir -p build
+
+# Compile WASM SIMD and C to a size-optimized WebAssembly module.
+# A small initial heap keeps instantiation cheap; it grows if many models
+# are loaded.
+emcc src/c/ann_wrapper.c src/asm/ann_simd.c \
+  -o build/neurobrain-infer.js \
+  -s EXPORTED_FUNCTIONS='["_create_network","_destroy_network","_load_network_params","_get_network_params","_get_network_layers","_load_model","_load_model_view","_load_ann_model","_run_network","_run_network_ctx","_create_inference_context","_destroy_inference_context","_run_ann_batch","_classify_batch","_get_network_weights","_set_network_normalization","_get_network_normalization","_malloc","_free"]' \
+  -s EXPORTED_RUNTIME_METHODS='["cwrap","HEAPF32"]' \
+  -s MODULARIZE=1 \
+  -s EXPORT_NAME='Module' \
+  -s WASM=1 \
+  -s ALLOW_MEMORY_GROWTH=1 \
+  -s INITIAL_MEMORY=1MB \
+  -s FILESYSTEM=0 \
+  -s MALLOC=emmalloc \
+  -DANN_INFERENCE_ONLY \
+  -Oz \
+  -msimd128
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Output files:"
+    echo "  - build/neurobrain-infer.js"
+    echo "  - build/neurobrain-infer.wasm"
+    echo ""
+    echo "Compare startup against the full module with:"
+    echo "  ./build.sh && node bench/startup_bench.js"
+else
+    echo "Build failed!"
+    exit 1
+fi
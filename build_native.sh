@@ -0,0 +1,48 @@
+#!/bin/bash
+# Native build script for Frankenstein Neural Web
+# Compiles the C orchestration layer against the native x86-64 SIMD backend
+# (SSE2/AVX2/AVX-512, selected at load time via CPUID) into a shared library
+# for server-side batch scoring and retraining. Data-parallel training
+# (train_ann_parallel) is enabled with pthreads. The WASM build is unaffected.
+
+echo "Building Frankenstein Neural Web (native x86-64)..."
+
+CC=${CC:-cc}
+
+# Check that a C compiler is available
+if ! command -v "$CC" &> /dev/null
+then
+    echo "Error: C compiler ($CC) not found. Set CC or install gcc/clang."
+    exit 1
+fi
+
+# The native backend only targets x86-64
+if [ "$(uname -m)" != "x86_64" ]; then
+    echo "Error: native SIMD backend requires an x86-64 host (found $(uname -m))"
+    exit 1
+fi
+
+# Create build directory if it doesn't exist
+mkdir -p build
+
+# Compile C and native SIMD kernels to a shared library.
+# No -march flag: the AVX2/AVX-512 kernels are enabled per function and
+# dispatched at runtime, so the library runs on any x86-64 CPU.
+$CC src/c/ann_wrapper.c src/c/csv_parser.c src/asm/ann_simd_x86.c \
+  -o build/libneurobrain.so \
+  -shared \
+  -fPIC \
+  -O3 \
+  -pthread \
+  -DANN_ENABLE_THREADS \
+  -lm
+
+if [ $? -eq 0 ]; then
+    echo "Build successful! Output files:"
+    echo "  - build/libneurobrain.so"
+    echo ""
+    echo "Set ANN_SIMD_ISA=sse2|avx2 to cap the runtime-selected instruction set."
+else
+    echo "Build failed!"
+    exit 1
+fi
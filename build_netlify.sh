@@ -23,15 +23,8 @@ cd $OLDPWD
 
 echo ""
 echo "Compiling WebAssembly with SIMD..."
-emcc src/asm/ann_simd.c src/c/ann_wrapper.c \
-    -o build/neurobrain.js \
-    -O3 \
-    -msimd128 \
-    -s WASM=1 \
-    -s ALLOW_MEMORY_GROWTH=1 \
-    -s INITIAL_MEMORY=16MB \
-    -s EXPORTED_FUNCTIONS='["_train_ann","_run_ann","_malloc","_free"]' \
-    -s EXPORTED_RUNTIME_METHODS='["cwrap","HEAPF32"]'
+# Same sources and exports as a local build (build.sh)
+bash build.sh
 
 echo ""
 echo "Creating deployment folder..."
@@ -44,6 +37,8 @@ cp src/web/style.css dist/
 cp src/web/app.js dist/
 cp src/web/encoder.js dist/
 cp src/web/modal-manager.js dist/
+cp src/web/train_stream.js dist/
+cp src/web/train_worker.js dist/
 cp build/neurobrain.js dist/
 cp build/neurobrain.wasm dist/
 
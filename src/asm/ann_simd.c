@@ -99,6 +99,149 @@ float sigmoid_derivative(float sigmoid_out) {
     return sigmoid_out * (1.0f - sigmoid_out);
 }
 
+// ============================================================================
+// exp_f32x4: Vectorized e^x approximation using WASM SIMD
+// Method (Cephes expf):
+//   x = n*ln2 + r with n = round(x / ln2) and |r| <= ln2/2
+//   e^r ≈ 1 + r + r² * P(r) with a degree-5 minimax polynomial P
+//   e^x = 2^n * e^r, where 2^n is built directly in the exponent bits
+// Parameters:
+//   x = input vector (clamped to [-87, 88] so 2^n stays a normal float)
+// Returns:
+//   e^x for each lane
+// Error bound:
+//   max relative error < 2.5e-7 (about 2 ulp) over the clamped range
+// ============================================================================
+static inline v128_t exp_f32x4(v128_t x) {
+    x = wasm_f32x4_min(wasm_f32x4_max(x, wasm_f32x4_splat(-87.0f)), wasm_f32x4_splat(88.0f));
+    
+    // Range reduction; ln2 is split into hi/lo parts to keep r accurate
+    v128_t n = wasm_f32x4_nearest(wasm_f32x4_mul(x, wasm_f32x4_splat(1.44269504088896341f)));
+    v128_t r = wasm_f32x4_sub(x, wasm_f32x4_mul(n, wasm_f32x4_splat(0.693359375f)));
+    r = wasm_f32x4_sub(r, wasm_f32x4_mul(n, wasm_f32x4_splat(-2.12194440e-4f)));
+    
+    // Polynomial approximation of e^r (Horner form)
+    v128_t p = wasm_f32x4_splat(1.9875691500e-4f);
+    p = wasm_f32x4_add(wasm_f32x4_mul(p, r), wasm_f32x4_splat(1.3981999507e-3f));
+    p = wasm_f32x4_add(wasm_f32x4_mul(p, r), wasm_f32x4_splat(8.3334519073e-3f));
+    p = wasm_f32x4_add(wasm_f32x4_mul(p, r), wasm_f32x4_splat(4.1665795894e-2f));
+    p = wasm_f32x4_add(wasm_f32x4_mul(p, r), wasm_f32x4_splat(1.6666665459e-1f));
+    p = wasm_f32x4_add(wasm_f32x4_mul(p, r), wasm_f32x4_splat(5.0000001201e-1f));
+    p = wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_mul(p, r), r),
+                       wasm_f32x4_add(r, wasm_f32x4_splat(1.0f)));
+    
+    // Scale by 2^n: (n + 127) << 23 is the IEEE-754 bit pattern of 2^n
+    v128_t pow2n = wasm_i32x4_shl(
+        wasm_i32x4_add(wasm_i32x4_trunc_sat_f32x4(n), wasm_i32x4_splat(127)), 23);
+    
+    return wasm_f32x4_mul(p, pow2n);
+}
+
+// sigmoid_f32x4: 1 / (1 + e^(-x)) for 4 lanes (saturates cleanly for large |x|)
+static inline v128_t sigmoid_f32x4(v128_t x) {
+    v128_t one = wasm_f32x4_splat(1.0f);
+    return wasm_f32x4_div(one, wasm_f32x4_add(one, exp_f32x4(wasm_f32x4_neg(x))));
+}
+
+// ============================================================================
+// sigmoid_forward_simd: Apply sigmoid activation using WASM SIMD
+// Formula: 1 / (1 + e^(-x)) with e^x from exp_f32x4
+// Parameters:
+//   input = input vector pointer
+//   output = output vector pointer (may alias input)
+//   length = number of elements
+// Returns:
+//   void (writes to output)
+// Error bound:
+//   max absolute error vs. exact sigmoid < 1e-7 over all finite inputs
+// Optimizations:
+//   - Loop unrolling for 8 elements at a time
+//   - Remaining elements are padded into one vector so every lane uses the
+//     same approximation (no scalar expf fallback)
+// ============================================================================
+void sigmoid_forward_simd(float* input, float* output, int length) {
+    if (length == 0) return;
+    
+    int i = 0;
+    
+    // Process 8 floats at a time using SIMD (loop unrolling)
+    int simd_length = length & ~7;  // Round down to multiple of 8
+    for (i = 0; i < simd_length; i += 8) {
+        v128_t x1 = wasm_v128_load(&input[i]);
+        v128_t x2 = wasm_v128_load(&input[i + 4]);
+        wasm_v128_store(&output[i], sigmoid_f32x4(x1));
+        wasm_v128_store(&output[i + 4], sigmoid_f32x4(x2));
+    }
+    
+    // Process remaining 4-element chunks
+    int simd_length4 = length & ~3;
+    for (; i < simd_length4; i += 4) {
+        v128_t x = wasm_v128_load(&input[i]);
+        wasm_v128_store(&output[i], sigmoid_f32x4(x));
+    }
+    
+    // Process remaining elements through a zero-padded vector
+    if (i < length) {
+        float tail[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        int remaining = length - i;
+        for (int j = 0; j < remaining; j++) tail[j] = input[i + j];
+        wasm_v128_store(tail, sigmoid_f32x4(wasm_v128_load(tail)));
+        for (int j = 0; j < remaining; j++) output[i + j] = tail[j];
+    }
+}
+
+// ============================================================================
+// sigmoid_backward_simd: Compute sigmoid derivative using WASM SIMD
+// Formula: sigmoid(x) * (1 - sigmoid(x))
+// Parameters:
+//   output = sigmoid output (pre-computed forward pass)
+//   grad_output = gradient from next layer
+//   grad_input = gradient to propagate (output, may alias grad_output)
+//   length = number of elements
+// Returns:
+//   void (writes to grad_input)
+// Optimizations:
+//   - Uses pre-computed sigmoid output to avoid recomputation
+//   - Loop unrolling for 8 elements at a time
+// ============================================================================
+void sigmoid_backward_simd(float* output, float* grad_output, float* grad_input, int length) {
+    if (length == 0) return;
+    
+    v128_t one = wasm_f32x4_splat(1.0f);
+    int i = 0;
+    
+    // Process 8 floats at a time using SIMD (loop unrolling)
+    int simd_length = length & ~7;  // Round down to multiple of 8
+    for (i = 0; i < simd_length; i += 8) {
+        v128_t s1 = wasm_v128_load(&output[i]);
+        v128_t s2 = wasm_v128_load(&output[i + 4]);
+        v128_t grad_out1 = wasm_v128_load(&grad_output[i]);
+        v128_t grad_out2 = wasm_v128_load(&grad_output[i + 4]);
+        
+        // Compute s * (1 - s)
+        v128_t derivative1 = wasm_f32x4_mul(s1, wasm_f32x4_sub(one, s1));
+        v128_t derivative2 = wasm_f32x4_mul(s2, wasm_f32x4_sub(one, s2));
+        
+        wasm_v128_store(&grad_input[i], wasm_f32x4_mul(grad_out1, derivative1));
+        wasm_v128_store(&grad_input[i + 4], wasm_f32x4_mul(grad_out2, derivative2));
+    }
+    
+    // Process remaining 4-element chunks
+    int simd_length4 = length & ~3;
+    for (; i < simd_length4; i += 4) {
+        v128_t s = wasm_v128_load(&output[i]);
+        v128_t grad_out = wasm_v128_load(&grad_output[i]);
+        v128_t derivative = wasm_f32x4_mul(s, wasm_f32x4_sub(one, s));
+        wasm_v128_store(&grad_input[i], wasm_f32x4_mul(grad_out, derivative));
+    }
+    
+    // Process remaining elements (scalar)
+    for (; i < length; i++) {
+        float s = output[i];
+        grad_input[i] = grad_output[i] * s * (1.0f - s);
+    }
+}
+
 // ============================================================================
 // relu_forward_simd: Apply ReLU activation using WASM SIMD
 // Formula: max(0, x)
@@ -405,3 +548,959 @@ void update_weights(float* weights, float* gradients, float lr, int length) {
         weights[i] -= lr * gradients[i];
     }
 }
+
+
+// tanh_f32x4: Rational tanh approximation for 4 lanes (same as tanh_forward_simd)
+static inline v128_t tanh_f32x4(v128_t x) {
+    x = wasm_f32x4_max(wasm_f32x4_min(x, wasm_f32x4_splat(5.0f)), wasm_f32x4_splat(-5.0f));
+    v128_t x_sq = wasm_f32x4_mul(x, x);
+    v128_t c27 = wasm_f32x4_splat(27.0f);
+    v128_t num = wasm_f32x4_mul(x, wasm_f32x4_add(c27, x_sq));
+    v128_t denom = wasm_f32x4_add(c27, wasm_f32x4_mul(wasm_f32x4_splat(9.0f), x_sq));
+    return wasm_f32x4_div(num, denom);
+}
+
+// activate_f32x4: Apply activation by type (0=sigmoid, 1=relu, 2=tanh,
+// 3=identity for logits, other=sigmoid)
+static inline v128_t activate_f32x4(v128_t x, int activation_type) {
+    switch (activation_type) {
+        case 1: return wasm_f32x4_max(x, wasm_f32x4_splat(0.0f));
+        case 2: return tanh_f32x4(x);
+        case 3: return x;
+        default: return sigmoid_f32x4(x);
+    }
+}
+
+// dense_forward_tail: Outputs [first, n_out) of a dense layer for one input row
+// (fewer than 4), computed as scalar weighted sums and activated as one
+// zero-padded vector. Single-output layers use dot_product directly since
+// their weight column is contiguous.
+static void dense_forward_tail(float* input, float* weights, float* bias, float* output,
+                               int n_in, int n_out, int first, int activation_type) {
+    float tail[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    int remaining = n_out - first;
+    
+    if (n_out == 1) {
+        tail[0] = bias[0] + dot_product(input, weights, n_in);
+    } else {
+        for (int k = 0; k < remaining; k++) {
+            float sum = bias[first + k];
+            for (int i = 0; i < n_in; i++) {
+                sum += input[i] * weights[i * n_out + first + k];
+            }
+            tail[k] = sum;
+        }
+    }
+    
+    wasm_v128_store(tail, activate_f32x4(wasm_v128_load(tail), activation_type));
+    for (int k = 0; k < remaining; k++) output[first + k] = tail[k];
+}
+
+// ============================================================================
+// dense_forward_simd: Fused dense layer forward pass (GEMV + bias + activation)
+// Formula: output[j] = act(bias[j] + sum_i input[i] * weights[i * n_out + j])
+// Parameters:
+//   input = input vector pointer [n_in]
+//   weights = input-major weight matrix [n_in][n_out]
+//   bias = bias vector pointer [n_out]
+//   output = activation output pointer [n_out] (must not alias input)
+//   n_in, n_out = layer dimensions
+//   activation_type = 0=sigmoid, 1=relu, 2=tanh, 3=identity (logits)
+// Returns:
+//   void (writes to output)
+// Optimizations:
+//   - Register blocking: 8 outputs accumulate in two vectors across all
+//     inputs, so each input is broadcast once per block and there is no
+//     horizontal sum
+//   - Input-major weights make every weight load a contiguous vector
+//   - Bias add and activation are applied in registers before the store
+// ============================================================================
+void dense_forward_simd(float* input, float* weights, float* bias, float* output,
+                        int n_in, int n_out, int activation_type) {
+    int j = 0;
+    
+    // Process 8 outputs at a time (two accumulators held in registers)
+    for (; j + 8 <= n_out; j += 8) {
+        v128_t acc1 = wasm_v128_load(&bias[j]);
+        v128_t acc2 = wasm_v128_load(&bias[j + 4]);
+        
+        for (int i = 0; i < n_in; i++) {
+            v128_t x = wasm_f32x4_splat(input[i]);
+            float* w = &weights[i * n_out + j];
+            acc1 = wasm_f32x4_add(acc1, wasm_f32x4_mul(x, wasm_v128_load(w)));
+            acc2 = wasm_f32x4_add(acc2, wasm_f32x4_mul(x, wasm_v128_load(w + 4)));
+        }
+        
+        wasm_v128_store(&output[j], activate_f32x4(acc1, activation_type));
+        wasm_v128_store(&output[j + 4], activate_f32x4(acc2, activation_type));
+    }
+    
+    // Process a remaining block of 4 outputs
+    for (; j + 4 <= n_out; j += 4) {
+        v128_t acc = wasm_v128_load(&bias[j]);
+        
+        for (int i = 0; i < n_in; i++) {
+            v128_t x = wasm_f32x4_splat(input[i]);
+            acc = wasm_f32x4_add(acc, wasm_f32x4_mul(x, wasm_v128_load(&weights[i * n_out + j])));
+        }
+        
+        wasm_v128_store(&output[j], activate_f32x4(acc, activation_type));
+    }
+    
+    // Remaining outputs
+    if (j < n_out) {
+        dense_forward_tail(input, weights, bias, output, n_in, n_out, j, activation_type);
+    }
+}
+
+// activate_array: Apply activation in place over a contiguous array
+static void activate_array(float* values, int length, int activation_type) {
+    int i = 0;
+    int simd_length4 = length & ~3;
+    for (; i < simd_length4; i += 4) {
+        wasm_v128_store(&values[i], activate_f32x4(wasm_v128_load(&values[i]), activation_type));
+    }
+    if (i < length) {
+        float tail[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        int remaining = length - i;
+        for (int k = 0; k < remaining; k++) tail[k] = values[i + k];
+        wasm_v128_store(tail, activate_f32x4(wasm_v128_load(tail), activation_type));
+        for (int k = 0; k < remaining; k++) values[i + k] = tail[k];
+    }
+}
+
+// ============================================================================
+// dense_forward_batch_simd: Fused dense layer forward pass for a mini-batch
+// Formula: outputs[r][j] = act(bias[j] + sum_i inputs[r][i] * weights[i][j])
+// Parameters:
+//   inputs = row-major input matrix [n_rows][n_in]
+//   weights = input-major weight matrix [n_in][n_out]
+//   bias = bias vector pointer [n_out]
+//   outputs = row-major activation matrix [n_rows][n_out]
+//   n_rows, n_in, n_out = matrix dimensions
+//   activation_type = 0=sigmoid, 1=relu, 2=tanh, 3=identity (logits)
+// Returns:
+//   void (writes to outputs)
+// Optimizations:
+//   - 4 rows x 8 outputs register block (8 accumulators): every weight
+//     vector loaded from memory is reused for 4 rows
+//   - Bias add and activation fused before the store
+//   - Leftover rows fall back to dense_forward_simd
+//   - Single-output layers activate the whole output column at once
+// ============================================================================
+void dense_forward_batch_simd(float* inputs, float* weights, float* bias, float* outputs,
+                              int n_rows, int n_in, int n_out, int activation_type) {
+    int r = 0;
+    
+    // Single-output layers: one dot product per row, then activate the
+    // contiguous output column in whole vectors
+    if (n_out == 1) {
+        for (r = 0; r < n_rows; r++) {
+            outputs[r] = bias[0] + dot_product(&inputs[r * n_in], weights, n_in);
+        }
+        activate_array(outputs, n_rows, activation_type);
+        return;
+    }
+    
+    // Process 4 rows at a time
+    for (; r + 4 <= n_rows; r += 4) {
+        float* x[4];
+        float* y[4];
+        for (int k = 0; k < 4; k++) {
+            x[k] = &inputs[(r + k) * n_in];
+            y[k] = &outputs[(r + k) * n_out];
+        }
+        
+        int j = 0;
+        
+        // 4 rows x 8 outputs
+        for (; j + 8 <= n_out; j += 8) {
+            v128_t b1 = wasm_v128_load(&bias[j]);
+            v128_t b2 = wasm_v128_load(&bias[j + 4]);
+            v128_t acc[4][2];
+            for (int k = 0; k < 4; k++) {
+                acc[k][0] = b1;
+                acc[k][1] = b2;
+            }
+            
+            for (int i = 0; i < n_in; i++) {
+                v128_t w1 = wasm_v128_load(&weights[i * n_out + j]);
+                v128_t w2 = wasm_v128_load(&weights[i * n_out + j + 4]);
+                for (int k = 0; k < 4; k++) {
+                    v128_t xv = wasm_f32x4_splat(x[k][i]);
+                    acc[k][0] = wasm_f32x4_add(acc[k][0], wasm_f32x4_mul(xv, w1));
+                    acc[k][1] = wasm_f32x4_add(acc[k][1], wasm_f32x4_mul(xv, w2));
+                }
+            }
+            
+            for (int k = 0; k < 4; k++) {
+                wasm_v128_store(&y[k][j], activate_f32x4(acc[k][0], activation_type));
+                wasm_v128_store(&y[k][j + 4], activate_f32x4(acc[k][1], activation_type));
+            }
+        }
+        
+        // 4 rows x 4 outputs
+        for (; j + 4 <= n_out; j += 4) {
+            v128_t b = wasm_v128_load(&bias[j]);
+            v128_t acc[4] = {b, b, b, b};
+            
+            for (int i = 0; i < n_in; i++) {
+                v128_t w = wasm_v128_load(&weights[i * n_out + j]);
+                for (int k = 0; k < 4; k++) {
+                    acc[k] = wasm_f32x4_add(acc[k], wasm_f32x4_mul(wasm_f32x4_splat(x[k][i]), w));
+                }
+            }
+            
+            for (int k = 0; k < 4; k++) {
+                wasm_v128_store(&y[k][j], activate_f32x4(acc[k], activation_type));
+            }
+        }
+        
+        // Remaining outputs (fewer than 4) row by row
+        if (j < n_out) {
+            for (int k = 0; k < 4; k++) {
+                dense_forward_tail(x[k], weights, bias, y[k], n_in, n_out, j, activation_type);
+            }
+        }
+    }
+    
+    // Process remaining rows one at a time
+    for (; r < n_rows; r++) {
+        dense_forward_simd(&inputs[r * n_in], weights, bias, &outputs[r * n_out],
+                           n_in, n_out, activation_type);
+    }
+}
+
+// ============================================================================
+// dense_backward_weights_simd: Accumulate dense layer gradients for a mini-batch
+// Formula: grad_weights[i][j] += sum_r inputs[r][i] * deltas[r][j]
+//          grad_bias[j]       += sum_r deltas[r][j]
+// Parameters:
+//   inputs = row-major layer input matrix [n_rows][n_in]
+//   deltas = row-major output delta matrix [n_rows][n_out]
+//   grad_weights = input-major gradient accumulator [n_in][n_out]
+//   grad_bias = bias gradient accumulator [n_out]
+//   n_rows, n_in, n_out = matrix dimensions
+// Returns:
+//   void (accumulates into grad_weights and grad_bias)
+// Optimizations:
+//   - 4 inputs x 8 outputs register block (8 accumulators) held across all
+//     rows, so each gradient element is loaded and stored once per call
+//   - Single-output layers vectorize across inputs instead
+// ============================================================================
+void dense_backward_weights_simd(float* inputs, float* deltas, float* grad_weights, float* grad_bias,
+                                 int n_rows, int n_in, int n_out) {
+    int j = 0;
+    
+    // Blocks of 8 outputs
+    for (; j + 8 <= n_out; j += 8) {
+        int i = 0;
+        
+        // 4 inputs x 8 outputs
+        for (; i + 4 <= n_in; i += 4) {
+            v128_t acc[4][2];
+            for (int k = 0; k < 4; k++) {
+                acc[k][0] = wasm_v128_load(&grad_weights[(i + k) * n_out + j]);
+                acc[k][1] = wasm_v128_load(&grad_weights[(i + k) * n_out + j + 4]);
+            }
+            
+            for (int r = 0; r < n_rows; r++) {
+                v128_t d1 = wasm_v128_load(&deltas[r * n_out + j]);
+                v128_t d2 = wasm_v128_load(&deltas[r * n_out + j + 4]);
+                float* x = &inputs[r * n_in + i];
+                for (int k = 0; k < 4; k++) {
+                    v128_t xv = wasm_f32x4_splat(x[k]);
+                    acc[k][0] = wasm_f32x4_add(acc[k][0], wasm_f32x4_mul(xv, d1));
+                    acc[k][1] = wasm_f32x4_add(acc[k][1], wasm_f32x4_mul(xv, d2));
+                }
+            }
+            
+            for (int k = 0; k < 4; k++) {
+                wasm_v128_store(&grad_weights[(i + k) * n_out + j], acc[k][0]);
+                wasm_v128_store(&grad_weights[(i + k) * n_out + j + 4], acc[k][1]);
+            }
+        }
+        
+        // Remaining inputs one at a time
+        for (; i < n_in; i++) {
+            v128_t acc1 = wasm_v128_load(&grad_weights[i * n_out + j]);
+            v128_t acc2 = wasm_v128_load(&grad_weights[i * n_out + j + 4]);
+            for (int r = 0; r < n_rows; r++) {
+                v128_t xv = wasm_f32x4_splat(inputs[r * n_in + i]);
+                acc1 = wasm_f32x4_add(acc1, wasm_f32x4_mul(xv, wasm_v128_load(&deltas[r * n_out + j])));
+                acc2 = wasm_f32x4_add(acc2, wasm_f32x4_mul(xv, wasm_v128_load(&deltas[r * n_out + j + 4])));
+            }
+            wasm_v128_store(&grad_weights[i * n_out + j], acc1);
+            wasm_v128_store(&grad_weights[i * n_out + j + 4], acc2);
+        }
+    }
+    
+    // Blocks of 4 outputs
+    for (; j + 4 <= n_out; j += 4) {
+        for (int i = 0; i < n_in; i++) {
+            v128_t acc = wasm_v128_load(&grad_weights[i * n_out + j]);
+            for (int r = 0; r < n_rows; r++) {
+                v128_t xv = wasm_f32x4_splat(inputs[r * n_in + i]);
+                acc = wasm_f32x4_add(acc, wasm_f32x4_mul(xv, wasm_v128_load(&deltas[r * n_out + j])));
+            }
+            wasm_v128_store(&grad_weights[i * n_out + j], acc);
+        }
+    }
+    
+    // Remaining outputs (fewer than 4)
+    if (n_out == 1) {
+        // Single output: grad_weights[:] += delta[r] * inputs[r][:]
+        int n_in4 = n_in & ~3;
+        for (int r = 0; r < n_rows; r++) {
+            v128_t d = wasm_f32x4_splat(deltas[r]);
+            float* x = &inputs[r * n_in];
+            int i = 0;
+            for (; i < n_in4; i += 4) {
+                v128_t g = wasm_v128_load(&grad_weights[i]);
+                wasm_v128_store(&grad_weights[i], wasm_f32x4_add(g, wasm_f32x4_mul(d, wasm_v128_load(&x[i]))));
+            }
+            for (; i < n_in; i++) {
+                grad_weights[i] += deltas[r] * x[i];
+            }
+        }
+    } else {
+        for (; j < n_out; j++) {
+            for (int i = 0; i < n_in; i++) {
+                float sum = 0.0f;
+                for (int r = 0; r < n_rows; r++) {
+                    sum += inputs[r * n_in + i] * deltas[r * n_out + j];
+                }
+                grad_weights[i * n_out + j] += sum;
+            }
+        }
+    }
+    
+    // Bias gradients: column sums of the delta matrix
+    int n_out4 = n_out & ~3;
+    for (int r = 0; r < n_rows; r++) {
+        float* d = &deltas[r * n_out];
+        int jj = 0;
+        for (; jj < n_out4; jj += 4) {
+            v128_t g = wasm_v128_load(&grad_bias[jj]);
+            wasm_v128_store(&grad_bias[jj], wasm_f32x4_add(g, wasm_v128_load(&d[jj])));
+        }
+        for (; jj < n_out; jj++) {
+            grad_bias[jj] += d[jj];
+        }
+    }
+}
+
+// ============================================================================
+// dense_backward_input_simd: Back-propagate deltas through a dense layer
+// Formula: grad_inputs[r][i] = sum_j deltas[r][j] * weights[i][j]
+// Parameters:
+//   deltas = row-major output delta matrix [n_rows][n_out]
+//   weights = input-major weight matrix [n_in][n_out]
+//   grad_inputs = row-major gradient w.r.t. layer inputs [n_rows][n_in]
+//   n_rows, n_in, n_out = matrix dimensions
+// Returns:
+//   void (writes to grad_inputs)
+// Optimizations:
+//   - Single-output layers reduce to a scaled copy of the weight column,
+//     vectorized across inputs
+//   - Otherwise each element is a contiguous dot product
+// ============================================================================
+void dense_backward_input_simd(float* deltas, float* weights, float* grad_inputs,
+                               int n_rows, int n_in, int n_out) {
+    if (n_out == 1) {
+        int n_in4 = n_in & ~3;
+        for (int r = 0; r < n_rows; r++) {
+            v128_t d = wasm_f32x4_splat(deltas[r]);
+            float* g = &grad_inputs[r * n_in];
+            int i = 0;
+            for (; i < n_in4; i += 4) {
+                wasm_v128_store(&g[i], wasm_f32x4_mul(d, wasm_v128_load(&weights[i])));
+            }
+            for (; i < n_in; i++) {
+                g[i] = deltas[r] * weights[i];
+            }
+        }
+        return;
+    }
+    
+    for (int r = 0; r < n_rows; r++) {
+        for (int i = 0; i < n_in; i++) {
+            grad_inputs[r * n_in + i] = dot_product(&deltas[r * n_out], &weights[i * n_out], n_out);
+        }
+    }
+}
+
+// ============================================================================
+// outer_product_update_simd: Rank-1 SGD update of a dense layer
+// Formula: weights[i][j] -= lr * x[i] * delta[j]
+//          bias[j] -= lr * delta[j]
+// Parameters:
+//   weights = input-major weight matrix [n_in][n_out] (modified in place)
+//   bias = bias vector [n_out] (modified in place, may be NULL)
+//   x = layer input vector [n_in]
+//   delta = layer output delta vector [n_out]
+//   lr = learning rate
+//   n_in, n_out = layer dimensions
+// Returns:
+//   void (modifies weights and bias in place)
+// Optimizations:
+//   - lr * delta is scaled once per 8-output block and reused for every row
+//   - Rows of the input-major matrix are contiguous, so each row update is
+//     a vector multiply-subtract with x[i] broadcast
+//   - Single-output layers vectorize down the weight column instead
+// ============================================================================
+void outer_product_update_simd(float* weights, float* bias, float* x, float* delta,
+                               float lr, int n_in, int n_out) {
+    v128_t lr_vec = wasm_f32x4_splat(lr);
+    
+    if (n_out == 1) {
+        float scaled = lr * delta[0];
+        v128_t s = wasm_f32x4_splat(scaled);
+        int n_in4 = n_in & ~3;
+        int i = 0;
+        for (; i < n_in4; i += 4) {
+            v128_t w = wasm_v128_load(&weights[i]);
+            wasm_v128_store(&weights[i], wasm_f32x4_sub(w, wasm_f32x4_mul(s, wasm_v128_load(&x[i]))));
+        }
+        for (; i < n_in; i++) {
+            weights[i] -= scaled * x[i];
+        }
+        if (bias != NULL) {
+            bias[0] -= scaled;
+        }
+        return;
+    }
+    
+    int j = 0;
+    
+    // 8-output blocks: two scaled-delta vectors held across all rows
+    int n_out8 = n_out & ~7;
+    for (; j < n_out8; j += 8) {
+        v128_t s0 = wasm_f32x4_mul(lr_vec, wasm_v128_load(&delta[j]));
+        v128_t s1 = wasm_f32x4_mul(lr_vec, wasm_v128_load(&delta[j + 4]));
+        for (int i = 0; i < n_in; i++) {
+            float* w = &weights[i * n_out + j];
+            v128_t xi = wasm_f32x4_splat(x[i]);
+            wasm_v128_store(&w[0], wasm_f32x4_sub(wasm_v128_load(&w[0]), wasm_f32x4_mul(s0, xi)));
+            wasm_v128_store(&w[4], wasm_f32x4_sub(wasm_v128_load(&w[4]), wasm_f32x4_mul(s1, xi)));
+        }
+        if (bias != NULL) {
+            wasm_v128_store(&bias[j], wasm_f32x4_sub(wasm_v128_load(&bias[j]), s0));
+            wasm_v128_store(&bias[j + 4], wasm_f32x4_sub(wasm_v128_load(&bias[j + 4]), s1));
+        }
+    }
+    
+    // Remaining 4-output block
+    int n_out4 = n_out & ~3;
+    for (; j < n_out4; j += 4) {
+        v128_t s0 = wasm_f32x4_mul(lr_vec, wasm_v128_load(&delta[j]));
+        for (int i = 0; i < n_in; i++) {
+            float* w = &weights[i * n_out + j];
+            wasm_v128_store(w, wasm_f32x4_sub(wasm_v128_load(w), wasm_f32x4_mul(s0, wasm_f32x4_splat(x[i]))));
+        }
+        if (bias != NULL) {
+            wasm_v128_store(&bias[j], wasm_f32x4_sub(wasm_v128_load(&bias[j]), s0));
+        }
+    }
+    
+    // Remaining outputs (scalar)
+    for (; j < n_out; j++) {
+        float scaled = lr * delta[j];
+        for (int i = 0; i < n_in; i++) {
+            weights[i * n_out + j] -= scaled * x[i];
+        }
+        if (bias != NULL) {
+            bias[j] -= scaled;
+        }
+    }
+}
+
+// ============================================================================
+// momentum_update_simd: SGD with (heavy-ball) momentum
+// Formula: velocity[i] = beta * velocity[i] + gradients[i]
+//          weights[i] -= lr * velocity[i]
+// Parameters:
+//   weights = parameter vector (modified in place)
+//   gradients = gradient vector
+//   velocity = momentum buffer (modified in place, zero before the first step)
+//   lr = learning rate
+//   beta = momentum coefficient
+//   length = number of elements
+// Returns:
+//   void (modifies weights and velocity in place)
+// ============================================================================
+void momentum_update_simd(float* weights, float* gradients, float* velocity,
+                          float lr, float beta, int length) {
+    v128_t lr_vec = wasm_f32x4_splat(lr);
+    v128_t beta_vec = wasm_f32x4_splat(beta);
+    int i = 0;
+    
+    int simd_length = length & ~3;
+    for (; i < simd_length; i += 4) {
+        v128_t v = wasm_f32x4_add(wasm_f32x4_mul(beta_vec, wasm_v128_load(&velocity[i])),
+                                  wasm_v128_load(&gradients[i]));
+        v128_t w = wasm_f32x4_sub(wasm_v128_load(&weights[i]), wasm_f32x4_mul(lr_vec, v));
+        wasm_v128_store(&velocity[i], v);
+        wasm_v128_store(&weights[i], w);
+    }
+    
+    for (; i < length; i++) {
+        velocity[i] = beta * velocity[i] + gradients[i];
+        weights[i] -= lr * velocity[i];
+    }
+}
+
+// ============================================================================
+// rmsprop_update_simd: RMSProp adaptive learning rate update
+// Formula: sq_avg[i] = rho * sq_avg[i] + (1 - rho) * gradients[i]^2
+//          weights[i] -= lr * gradients[i] / (sqrt(sq_avg[i]) + eps)
+// Parameters:
+//   weights = parameter vector (modified in place)
+//   gradients = gradient vector
+//   sq_avg = running average of squared gradients (modified in place)
+//   lr = learning rate
+//   rho = decay rate of the squared-gradient average
+//   eps = denominator stabilizer
+//   length = number of elements
+// Returns:
+//   void (modifies weights and sq_avg in place)
+// ============================================================================
+void rmsprop_update_simd(float* weights, float* gradients, float* sq_avg,
+                         float lr, float rho, float eps, int length) {
+    v128_t lr_vec = wasm_f32x4_splat(lr);
+    v128_t rho_vec = wasm_f32x4_splat(rho);
+    v128_t one_minus_rho = wasm_f32x4_splat(1.0f - rho);
+    v128_t eps_vec = wasm_f32x4_splat(eps);
+    int i = 0;
+    
+    int simd_length = length & ~3;
+    for (; i < simd_length; i += 4) {
+        v128_t g = wasm_v128_load(&gradients[i]);
+        v128_t s = wasm_f32x4_add(wasm_f32x4_mul(rho_vec, wasm_v128_load(&sq_avg[i])),
+                                  wasm_f32x4_mul(one_minus_rho, wasm_f32x4_mul(g, g)));
+        v128_t denom = wasm_f32x4_add(wasm_f32x4_sqrt(s), eps_vec);
+        v128_t step = wasm_f32x4_div(wasm_f32x4_mul(lr_vec, g), denom);
+        wasm_v128_store(&sq_avg[i], s);
+        wasm_v128_store(&weights[i], wasm_f32x4_sub(wasm_v128_load(&weights[i]), step));
+    }
+    
+    for (; i < length; i++) {
+        float g = gradients[i];
+        sq_avg[i] = rho * sq_avg[i] + (1.0f - rho) * (g * g);
+        weights[i] -= (lr * g) / (sqrtf(sq_avg[i]) + eps);
+    }
+}
+
+// ============================================================================
+// adam_update_simd: Adam update with bias-corrected moment estimates
+// Formula: m[i] = beta1 * m[i] + (1 - beta1) * gradients[i]
+//          v[i] = beta2 * v[i] + (1 - beta2) * gradients[i]^2
+//          weights[i] -= lr * (m[i] * m_scale) / (sqrt(v[i] * v_scale) + eps)
+// Parameters:
+//   weights = parameter vector (modified in place)
+//   gradients = gradient vector
+//   m, v = first and second moment buffers (modified in place)
+//   lr = learning rate
+//   beta1, beta2 = moment decay rates
+//   eps = denominator stabilizer
+//   m_scale, v_scale = bias corrections 1 / (1 - beta^t) for step t
+// Returns:
+//   void (modifies weights, m and v in place)
+// ============================================================================
+void adam_update_simd(float* weights, float* gradients, float* m, float* v,
+                      float lr, float beta1, float beta2, float eps,
+                      float m_scale, float v_scale, int length) {
+    v128_t b1 = wasm_f32x4_splat(beta1);
+    v128_t one_minus_b1 = wasm_f32x4_splat(1.0f - beta1);
+    v128_t b2 = wasm_f32x4_splat(beta2);
+    v128_t one_minus_b2 = wasm_f32x4_splat(1.0f - beta2);
+    v128_t step_scale = wasm_f32x4_splat(lr * m_scale);
+    v128_t v_scale_vec = wasm_f32x4_splat(v_scale);
+    v128_t eps_vec = wasm_f32x4_splat(eps);
+    int i = 0;
+    
+    int simd_length = length & ~3;
+    for (; i < simd_length; i += 4) {
+        v128_t g = wasm_v128_load(&gradients[i]);
+        v128_t m_new = wasm_f32x4_add(wasm_f32x4_mul(b1, wasm_v128_load(&m[i])),
+                                      wasm_f32x4_mul(one_minus_b1, g));
+        v128_t v_new = wasm_f32x4_add(wasm_f32x4_mul(b2, wasm_v128_load(&v[i])),
+                                      wasm_f32x4_mul(one_minus_b2, wasm_f32x4_mul(g, g)));
+        v128_t denom = wasm_f32x4_add(wasm_f32x4_sqrt(wasm_f32x4_mul(v_new, v_scale_vec)), eps_vec);
+        v128_t step = wasm_f32x4_div(wasm_f32x4_mul(step_scale, m_new), denom);
+        wasm_v128_store(&m[i], m_new);
+        wasm_v128_store(&v[i], v_new);
+        wasm_v128_store(&weights[i], wasm_f32x4_sub(wasm_v128_load(&weights[i]), step));
+    }
+    
+    float scaled_lr = lr * m_scale;
+    for (; i < length; i++) {
+        float g = gradients[i];
+        m[i] = beta1 * m[i] + (1.0f - beta1) * g;
+        v[i] = beta2 * v[i] + (1.0f - beta2) * (g * g);
+        weights[i] -= (scaled_lr * m[i]) / (sqrtf(v[i] * v_scale) + eps);
+    }
+}
+
+// ============================================================================
+// find_csv_delimiters_simd: Index every field and record delimiter in a block
+// of CSV text
+// Parameters:
+//   data = text block pointer
+//   length = number of bytes in data
+//   positions = output offsets (capacity length) of every ',' and '\n'
+// Returns:
+//   number of offsets written, in ascending order
+// Optimizations:
+//   - Compares 16 bytes per step against both delimiters
+//   - Byte-mask bitmask: blocks with no delimiter cost one branch
+//   - Set bits are walked with count-trailing-zeros
+// ============================================================================
+int find_csv_delimiters_simd(const char* data, int length, int* positions) {
+    v128_t comma = wasm_i8x16_splat(',');
+    v128_t newline = wasm_i8x16_splat('\n');
+    int count = 0;
+    int i = 0;
+    
+    // Process 16 bytes at a time using SIMD
+    int simd_length = length & ~15;
+    for (i = 0; i < simd_length; i += 16) {
+        v128_t bytes = wasm_v128_load(&data[i]);
+        v128_t hits = wasm_v128_or(wasm_i8x16_eq(bytes, comma), wasm_i8x16_eq(bytes, newline));
+        unsigned int mask = wasm_i8x16_bitmask(hits);
+        while (mask != 0) {
+            positions[count++] = i + __builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+    
+    // Process remaining bytes (scalar)
+    for (; i < length; i++) {
+        if (data[i] == ',' || data[i] == '\n') {
+            positions[count++] = i;
+        }
+    }
+    
+    return count;
+}
+
+// Vectors per block in column_stats_simd / affine_columns_simd. Tables whose
+// blocks would need more (over 16 columns, none sharing a factor with 4) take
+// the scalar path.
+#define COLUMN_BLOCK_VECTORS 16
+
+static int gcd_int(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Fold a partial (count_b rows: mean_b, m2_b, min_b, max_b) into the running
+// statistics of column c, which cover count_a rows (Chan et al.)
+static void merge_column_stats(float* mean, float* m2, float* min, float* max, int c, int count_a,
+                               int count_b, float mean_b, float m2_b, float min_b, float max_b) {
+    float count = (float)count_a + (float)count_b;
+    float delta = mean_b - mean[c];
+    mean[c] += delta * ((float)count_b / count);
+    m2[c] += m2_b + delta * delta * ((float)count_a * (float)count_b / count);
+    min[c] = min_b < min[c] ? min_b : min[c];
+    max[c] = max_b > max[c] ? max_b : max[c];
+}
+
+// ============================================================================
+// column_stats_simd: Per-column mean, variance, min and max of a row-major
+// matrix in one pass (Welford's algorithm)
+// Parameters:
+//   data = matrix pointer ([n_rows][n_cols], row-major)
+//   n_rows = number of rows (at least 1)
+//   n_cols = number of columns
+//   mean, variance, min, max = outputs [n_cols] (variance is the population
+//                              variance)
+// Optimizations:
+//   - The matrix is walked in blocks of lcm(n_cols, 4) floats, so lane j of
+//     the k-th vector of every block always reads the same column and runs
+//     its own Welford recurrence without gathers or shuffles
+//   - One reciprocal per block instead of a division per element
+//   - Lane partials are merged per column with Chan's formula; leftover rows
+//     are folded in with scalar Welford updates
+// ============================================================================
+void column_stats_simd(float* data, int n_rows, int n_cols,
+                       float* mean, float* variance, float* min, float* max) {
+    int n_vectors = n_cols / gcd_int(n_cols, 4);
+    int block_rows = 4 * n_vectors / n_cols;
+    int n_blocks = n_vectors <= COLUMN_BLOCK_VECTORS ? n_rows / block_rows : 0;
+    
+    // variance holds the sum of squared deviations (M2) until the end
+    for (int c = 0; c < n_cols; c++) {
+        mean[c] = 0.0f;
+        variance[c] = 0.0f;
+        min[c] = INFINITY;
+        max[c] = -INFINITY;
+    }
+    
+    if (n_blocks > 0) {
+        v128_t v_mean[COLUMN_BLOCK_VECTORS];
+        v128_t v_m2[COLUMN_BLOCK_VECTORS];
+        v128_t v_min[COLUMN_BLOCK_VECTORS];
+        v128_t v_max[COLUMN_BLOCK_VECTORS];
+        for (int k = 0; k < n_vectors; k++) {
+            v_mean[k] = wasm_f32x4_splat(0.0f);
+            v_m2[k] = wasm_f32x4_splat(0.0f);
+            v_min[k] = wasm_f32x4_splat(INFINITY);
+            v_max[k] = wasm_f32x4_splat(-INFINITY);
+        }
+        
+        for (int b = 0; b < n_blocks; b++) {
+            float* block = &data[(size_t)b * block_rows * n_cols];
+            v128_t inv_count = wasm_f32x4_splat(1.0f / (float)(b + 1));
+            for (int k = 0; k < n_vectors; k++) {
+                v128_t x = wasm_v128_load(&block[k * 4]);
+                v128_t delta = wasm_f32x4_sub(x, v_mean[k]);
+                v_mean[k] = wasm_f32x4_add(v_mean[k], wasm_f32x4_mul(delta, inv_count));
+                v_m2[k] = wasm_f32x4_add(v_m2[k], wasm_f32x4_mul(delta, wasm_f32x4_sub(x, v_mean[k])));
+                v_min[k] = wasm_f32x4_min(v_min[k], x);
+                v_max[k] = wasm_f32x4_max(v_max[k], x);
+            }
+        }
+        
+        // Lane at block offset k * 4 + j covers column offset % n_cols; earlier
+        // lanes of the same column have already been merged
+        for (int k = 0; k < n_vectors; k++) {
+            float lane_mean[4], lane_m2[4], lane_min[4], lane_max[4];
+            wasm_v128_store(lane_mean, v_mean[k]);
+            wasm_v128_store(lane_m2, v_m2[k]);
+            wasm_v128_store(lane_min, v_min[k]);
+            wasm_v128_store(lane_max, v_max[k]);
+            for (int j = 0; j < 4; j++) {
+                int offset = k * 4 + j;
+                merge_column_stats(mean, variance, min, max, offset % n_cols, offset / n_cols * n_blocks,
+                                   n_blocks, lane_mean[j], lane_m2[j], lane_min[j], lane_max[j]);
+            }
+        }
+    }
+    
+    // Process remaining rows (scalar Welford)
+    for (int r = n_blocks * block_rows; r < n_rows; r++) {
+        float inv_count = 1.0f / (float)(r + 1);
+        for (int c = 0; c < n_cols; c++) {
+            float x = data[(size_t)r * n_cols + c];
+            float delta = x - mean[c];
+            mean[c] += delta * inv_count;
+            variance[c] += delta * (x - mean[c]);
+            min[c] = x < min[c] ? x : min[c];
+            max[c] = x > max[c] ? x : max[c];
+        }
+    }
+    
+    for (int c = 0; c < n_cols; c++) {
+        variance[c] /= (float)n_rows;
+    }
+}
+
+// ============================================================================
+// affine_columns_simd: In-place per-column affine transform of a row-major
+// matrix (feature normalization)
+// Formula: data[r][c] = (data[r][c] - offset[c]) * scale[c]
+// Parameters:
+//   data = matrix pointer ([n_rows][n_cols], row-major)
+//   n_rows = number of rows
+//   n_cols = number of columns
+//   offset, scale = per-column transform [n_cols]
+// Optimizations:
+//   - Same lcm(n_cols, 4) blocking as column_stats_simd: offset and scale are
+//     expanded once into per-lane vectors, then every block is a plain
+//     load/sub/mul/store stream
+//   - Results are bit-identical to the scalar formula
+// ============================================================================
+void affine_columns_simd(float* data, int n_rows, int n_cols, const float* offset, const float* scale) {
+    int n_vectors = n_cols / gcd_int(n_cols, 4);
+    int block_rows = 4 * n_vectors / n_cols;
+    int n_blocks = n_vectors <= COLUMN_BLOCK_VECTORS ? n_rows / block_rows : 0;
+    
+    if (n_blocks > 0) {
+        v128_t v_offset[COLUMN_BLOCK_VECTORS];
+        v128_t v_scale[COLUMN_BLOCK_VECTORS];
+        for (int k = 0; k < n_vectors; k++) {
+            float lane_offset[4], lane_scale[4];
+            for (int j = 0; j < 4; j++) {
+                lane_offset[j] = offset[(k * 4 + j) % n_cols];
+                lane_scale[j] = scale[(k * 4 + j) % n_cols];
+            }
+            v_offset[k] = wasm_v128_load(lane_offset);
+            v_scale[k] = wasm_v128_load(lane_scale);
+        }
+        
+        for (int b = 0; b < n_blocks; b++) {
+            float* block = &data[(size_t)b * block_rows * n_cols];
+            for (int k = 0; k < n_vectors; k++) {
+                v128_t x = wasm_v128_load(&block[k * 4]);
+                wasm_v128_store(&block[k * 4], wasm_f32x4_mul(wasm_f32x4_sub(x, v_offset[k]), v_scale[k]));
+            }
+        }
+    }
+    
+    // Process remaining rows (scalar)
+    for (int r = n_blocks * block_rows; r < n_rows; r++) {
+        float* row = &data[(size_t)r * n_cols];
+        for (int c = 0; c < n_cols; c++) {
+            row[c] = (row[c] - offset[c]) * scale[c];
+        }
+    }
+}
+
+// Horizontal max of the 4 lanes
+static inline float hmax_f32x4(v128_t v) {
+    float a = fmaxf(wasm_f32x4_extract_lane(v, 0), wasm_f32x4_extract_lane(v, 1));
+    float b = fmaxf(wasm_f32x4_extract_lane(v, 2), wasm_f32x4_extract_lane(v, 3));
+    return fmaxf(a, b);
+}
+
+// Largest value of a row (vector max, then the lanes and the scalar tail)
+static float row_max(const float* row, int length) {
+    v128_t max_vec = wasm_f32x4_splat(-INFINITY);
+    int i = 0;
+    int simd_length4 = length & ~3;
+    for (; i < simd_length4; i += 4) {
+        max_vec = wasm_f32x4_max(max_vec, wasm_v128_load(&row[i]));
+    }
+    float max = hmax_f32x4(max_vec);
+    for (; i < length; i++) {
+        max = row[i] > max ? row[i] : max;
+    }
+    return max;
+}
+
+// ============================================================================
+// softmax_forward_simd: Row-wise softmax of a logit matrix
+// Formula: probs[r][k] = e^(logits[r][k] - m) / sum_j e^(logits[r][j] - m)
+//          with m = max_j logits[r][j]
+// Parameters:
+//   logits = row-major logit matrix [n_rows][n_classes]
+//   probs = row-major probability output [n_rows][n_classes] (may alias logits)
+//   n_rows = number of rows
+//   n_classes = classes per row (at least 1)
+// Returns:
+//   void (writes to probs)
+// Optimizations:
+//   - Max subtraction keeps every exponent <= 0, so exp_f32x4 never
+//     overflows and the smallest probability stays above 1e-38 instead of 0
+//   - Exponentials are summed in a vector accumulator as they are stored;
+//     the row is then scaled by one reciprocal instead of n_classes divisions
+//   - Leftover classes are evaluated as one zero-padded vector
+// ============================================================================
+void softmax_forward_simd(float* logits, float* probs, int n_rows, int n_classes) {
+    int simd_length4 = n_classes & ~3;
+    
+    for (int r = 0; r < n_rows; r++) {
+        float* z = &logits[(size_t)r * n_classes];
+        float* p = &probs[(size_t)r * n_classes];
+        v128_t max_vec = wasm_f32x4_splat(row_max(z, n_classes));
+        v128_t sum_vec = wasm_f32x4_splat(0.0f);
+        int i = 0;
+    
+        for (; i < simd_length4; i += 4) {
+            v128_t e = exp_f32x4(wasm_f32x4_sub(wasm_v128_load(&z[i]), max_vec));
+            wasm_v128_store(&p[i], e);
+            sum_vec = wasm_f32x4_add(sum_vec, e);
+        }
+    
+        float sum = wasm_f32x4_extract_lane(sum_vec, 0) +
+                    wasm_f32x4_extract_lane(sum_vec, 1) +
+                    wasm_f32x4_extract_lane(sum_vec, 2) +
+                    wasm_f32x4_extract_lane(sum_vec, 3);
+    
+        if (i < n_classes) {
+            float tail[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            int remaining = n_classes - i;
+            for (int k = 0; k < remaining; k++) tail[k] = z[i + k];
+            wasm_v128_store(tail, exp_f32x4(wasm_f32x4_sub(wasm_v128_load(tail), max_vec)));
+            for (int k = 0; k < remaining; k++) {
+                p[i + k] = tail[k];
+                sum += tail[k];
+            }
+        }
+    
+        float inv_sum = 1.0f / sum;
+        v128_t inv_vec = wasm_f32x4_splat(inv_sum);
+        for (i = 0; i < simd_length4; i += 4) {
+            wasm_v128_store(&p[i], wasm_f32x4_mul(wasm_v128_load(&p[i]), inv_vec));
+        }
+        for (; i < n_classes; i++) {
+            p[i] *= inv_sum;
+        }
+    }
+}
+
+// ============================================================================
+// softmax_cross_entropy_backward_simd: Fused softmax + cross-entropy gradient
+// Formula: deltas[r][k] = probs[r][k] - (k == labels[r] ? 1 : 0)
+//          loss = sum_r -ln(max(probs[r][labels[r]], 1e-7))
+// Parameters:
+//   probs = softmax output [n_rows][n_classes] (from softmax_forward_simd)
+//   labels = class index per row [n_rows], stored as integral floats in
+//            [0, n_classes)
+//   deltas = gradient of the loss w.r.t. the logits [n_rows][n_classes]
+//            (may alias probs)
+//   n_rows, n_classes = matrix dimensions
+// Returns:
+//   summed cross-entropy loss over the rows
+// Optimizations:
+//   - The softmax Jacobian is never formed: combined with cross-entropy it
+//     collapses to p - onehot, a vector copy plus one scalar subtraction
+//   - The probability floor keeps the loss finite for confident mistakes
+//     without affecting the gradient
+// ============================================================================
+float softmax_cross_entropy_backward_simd(float* probs, const float* labels, float* deltas,
+                                          int n_rows, int n_classes) {
+    int simd_length4 = n_classes & ~3;
+    float loss = 0.0f;
+    
+    for (int r = 0; r < n_rows; r++) {
+        float* p = &probs[(size_t)r * n_classes];
+        float* d = &deltas[(size_t)r * n_classes];
+        int label = (int)labels[r];
+        float p_label = p[label];
+        int i = 0;
+    
+        if (d != p) {
+            for (; i < simd_length4; i += 4) {
+                wasm_v128_store(&d[i], wasm_v128_load(&p[i]));
+            }
+            for (; i < n_classes; i++) {
+                d[i] = p[i];
+            }
+        }
+    
+        d[label] = p_label - 1.0f;
+        loss -= logf(p_label > 1e-7f ? p_label : 1e-7f);
+    }
+    
+    return loss;
+}
+
+// ============================================================================
+// argmax_rows_simd: Index of the largest value in every row (batched class
+// decoding)
+// Parameters:
+//   values = row-major matrix [n_rows][n_cols]
+//   n_rows = number of rows
+//   n_cols = columns per row (at least 1)
+//   indices = output [n_rows]; ties resolve to the lowest column
+// Returns:
+//   void (writes to indices)
+// Optimizations:
+//   - The row maximum comes from a vector max reduction; a single forward
+//     scan then stops at its first occurrence
+// ============================================================================
+void argmax_rows_simd(float* values, int n_rows, int n_cols, int* indices) {
+    for (int r = 0; r < n_rows; r++) {
+        float* row = &values[(size_t)r * n_cols];
+        float max = row_max(row, n_cols);
+        int index = 0;
+        while (index < n_cols - 1 && row[index] != max) index++;
+        indices[r] = index;
+    }
+}
@@ -0,0 +1,369 @@
+// Native x86-64 implementation of neural network core functions
+// Provides the same kernel API as ann_simd.c (WebAssembly SIMD) for native
+// builds, with SSE2, AVX2 and AVX-512 variants selected at load time via CPUID.
+// The kernel bodies live in ann_simd_x86_kernels.inc and are instantiated once
+// per instruction set below.
+
+#include <immintrin.h>
+#include <cpuid.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Kernel dispatch table (one instance per instruction set)
+typedef struct {
+    const char* name;
+    float (*dot_product)(float* vec1, float* vec2, int length);
+    void (*relu_forward_simd)(float* input, float* output, int length);
+    void (*relu_backward_simd)(float* input, float* grad_output, float* grad_input, int length);
+    void (*tanh_forward_simd)(float* input, float* output, int length);
+    void (*tanh_backward_simd)(float* output, float* grad_output, float* grad_input, int length);
+    void (*sigmoid_forward_simd)(float* input, float* output, int length);
+    void (*sigmoid_backward_simd)(float* output, float* grad_output, float* grad_input, int length);
+    void (*update_weights)(float* weights, float* gradients, float lr, int length);
+    void (*dense_forward_simd)(float* input, float* weights, float* bias, float* output,
+                               int n_in, int n_out, int activation_type);
+    void (*dense_forward_batch_simd)(float* inputs, float* weights, float* bias, float* outputs,
+                                     int n_rows, int n_in, int n_out, int activation_type);
+    void (*dense_backward_weights_simd)(float* inputs, float* deltas, float* grad_weights, float* grad_bias,
+                                        int n_rows, int n_in, int n_out);
+    void (*dense_backward_input_simd)(float* deltas, float* weights, float* grad_inputs,
+                                      int n_rows, int n_in, int n_out);
+    void (*outer_product_update_simd)(float* weights, float* bias, float* x, float* delta,
+                                      float lr, int n_in, int n_out);
+    void (*momentum_update_simd)(float* weights, float* gradients, float* velocity,
+                                 float lr, float beta, int length);
+    void (*rmsprop_update_simd)(float* weights, float* gradients, float* sq_avg,
+                                float lr, float rho, float eps, int length);
+    void (*adam_update_simd)(float* weights, float* gradients, float* m, float* v,
+                             float lr, float beta1, float beta2, float eps,
+                             float m_scale, float v_scale, int length);
+    int (*find_csv_delimiters_simd)(const char* data, int length, int* positions);
+    void (*column_stats_simd)(float* data, int n_rows, int n_cols,
+                              float* mean, float* variance, float* min, float* max);
+    void (*affine_columns_simd)(float* data, int n_rows, int n_cols, const float* offset, const float* scale);
+    void (*softmax_forward_simd)(float* logits, float* probs, int n_rows, int n_classes);
+    float (*softmax_cross_entropy_backward_simd)(float* probs, const float* labels, float* deltas,
+                                                 int n_rows, int n_classes);
+    void (*argmax_rows_simd)(float* values, int n_rows, int n_cols, int* indices);
+} SimdKernels;
+
+// Horizontal sum of a 4-wide SSE vector (SSE2 only)
+static inline float hsum_m128(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+// Bitmask of the bytes in v equal to a or b (SSE2 only)
+static inline unsigned int csv_mask_m128i(__m128i v, char a, char b) {
+    __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(a)), _mm_cmpeq_epi8(v, _mm_set1_epi8(b)));
+    return (unsigned int)_mm_movemask_epi8(hits);
+}
+
+// Vectors per block in column_stats_simd / affine_columns_simd. Tables whose
+// blocks would need more take the scalar path.
+#define COLUMN_BLOCK_VECTORS 16
+
+static int gcd_int(int a, int b) {
+    while (b != 0) {
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Fold a partial (count_b rows: mean_b, m2_b, min_b, max_b) into the running
+// statistics of column c, which cover count_a rows (Chan et al.)
+static void merge_column_stats(float* mean, float* m2, float* min, float* max, int c, int count_a,
+                               int count_b, float mean_b, float m2_b, float min_b, float max_b) {
+    float count = (float)count_a + (float)count_b;
+    float delta = mean_b - mean[c];
+    mean[c] += delta * ((float)count_b / count);
+    m2[c] += m2_b + delta * delta * ((float)count_a * (float)count_b / count);
+    min[c] = min_b < min[c] ? min_b : min[c];
+    max[c] = max_b > max[c] ? max_b : max[c];
+}
+
+// ============================================================================
+// SSE2 backend (baseline for every x86-64 CPU)
+// ============================================================================
+#define VW 4
+#define vf __m128
+#define ISA_NAME "sse2"
+#define ISA_FN(name) name##_sse2
+#define ISA_TARGET
+#define V_ZERO() _mm_setzero_ps()
+#define V_SET1(x) _mm_set1_ps(x)
+#define V_LOAD(p) _mm_loadu_ps(p)
+#define V_STORE(p, v) _mm_storeu_ps((p), (v))
+#define V_ADD(a, b) _mm_add_ps((a), (b))
+#define V_SUB(a, b) _mm_sub_ps((a), (b))
+#define V_MUL(a, b) _mm_mul_ps((a), (b))
+#define V_DIV(a, b) _mm_div_ps((a), (b))
+#define V_SQRT(a) _mm_sqrt_ps(a)
+#define V_MIN(a, b) _mm_min_ps((a), (b))
+#define V_MAX(a, b) _mm_max_ps((a), (b))
+#define V_FMADD(a, b, c) _mm_add_ps(_mm_mul_ps((a), (b)), (c))
+#define V_HSUM(v) hsum_m128(v)
+#define V_SELECT_GT0(x, g) _mm_and_ps((g), _mm_cmpgt_ps((x), _mm_setzero_ps()))
+#define vi __m128i
+#define V_CVT_NEAREST(v) _mm_cvtps_epi32(v)
+#define V_CVT_I2F(n) _mm_cvtepi32_ps(n)
+#define V_POW2I(n) _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32((n), _mm_set1_epi32(127)), 23))
+#define VB 16
+#define V_BYTE_EQ2_MASK(p, a, b) csv_mask_m128i(_mm_loadu_si128((const __m128i*)(p)), (a), (b))
+#include "ann_simd_x86_kernels.inc"
+
+// ============================================================================
+// AVX2 + FMA backend
+// ============================================================================
+__attribute__((target("avx2,fma")))
+static inline float hsum_m256(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum_m128(_mm_add_ps(lo, hi));
+}
+
+// Bitmask of the bytes in v equal to a or b (AVX2)
+__attribute__((target("avx2")))
+static inline unsigned int csv_mask_m256i(__m256i v, char a, char b) {
+    __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(a)), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(b)));
+    return (unsigned int)_mm256_movemask_epi8(hits);
+}
+
+#define VW 8
+#define vf __m256
+#define ISA_NAME "avx2"
+#define ISA_FN(name) name##_avx2
+#define ISA_TARGET __attribute__((target("avx2,fma")))
+#define V_ZERO() _mm256_setzero_ps()
+#define V_SET1(x) _mm256_set1_ps(x)
+#define V_LOAD(p) _mm256_loadu_ps(p)
+#define V_STORE(p, v) _mm256_storeu_ps((p), (v))
+#define V_ADD(a, b) _mm256_add_ps((a), (b))
+#define V_SUB(a, b) _mm256_sub_ps((a), (b))
+#define V_MUL(a, b) _mm256_mul_ps((a), (b))
+#define V_DIV(a, b) _mm256_div_ps((a), (b))
+#define V_SQRT(a) _mm256_sqrt_ps(a)
+#define V_MIN(a, b) _mm256_min_ps((a), (b))
+#define V_MAX(a, b) _mm256_max_ps((a), (b))
+#define V_FMADD(a, b, c) _mm256_fmadd_ps((a), (b), (c))
+#define V_HSUM(v) hsum_m256(v)
+#define V_SELECT_GT0(x, g) _mm256_and_ps((g), _mm256_cmp_ps((x), _mm256_setzero_ps(), _CMP_GT_OQ))
+#define vi __m256i
+#define V_CVT_NEAREST(v) _mm256_cvtps_epi32(v)
+#define V_CVT_I2F(n) _mm256_cvtepi32_ps(n)
+#define V_POW2I(n) _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32((n), _mm256_set1_epi32(127)), 23))
+#define VB 32
+#define V_BYTE_EQ2_MASK(p, a, b) csv_mask_m256i(_mm256_loadu_si256((const __m256i*)(p)), (a), (b))
+#include "ann_simd_x86_kernels.inc"
+
+// ============================================================================
+// AVX-512F backend
+// ============================================================================
+#define VW 16
+#define vf __m512
+#define ISA_NAME "avx512"
+#define ISA_FN(name) name##_avx512
+#define ISA_TARGET __attribute__((target("avx512f")))
+#define V_ZERO() _mm512_setzero_ps()
+#define V_SET1(x) _mm512_set1_ps(x)
+#define V_LOAD(p) _mm512_loadu_ps(p)
+#define V_STORE(p, v) _mm512_storeu_ps((p), (v))
+#define V_ADD(a, b) _mm512_add_ps((a), (b))
+#define V_SUB(a, b) _mm512_sub_ps((a), (b))
+#define V_MUL(a, b) _mm512_mul_ps((a), (b))
+#define V_DIV(a, b) _mm512_div_ps((a), (b))
+#define V_SQRT(a) _mm512_sqrt_ps(a)
+#define V_MIN(a, b) _mm512_min_ps((a), (b))
+#define V_MAX(a, b) _mm512_max_ps((a), (b))
+#define V_FMADD(a, b, c) _mm512_fmadd_ps((a), (b), (c))
+#define V_HSUM(v) _mm512_reduce_add_ps(v)
+#define V_SELECT_GT0(x, g) _mm512_maskz_mov_ps(_mm512_cmp_ps_mask((x), _mm512_setzero_ps(), _CMP_GT_OQ), (g))
+#define vi __m512i
+#define V_CVT_NEAREST(v) _mm512_cvtps_epi32(v)
+#define V_CVT_I2F(n) _mm512_cvtepi32_ps(n)
+#define V_POW2I(n) _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32((n), _mm512_set1_epi32(127)), 23))
+// Byte compares need AVX512BW, so the byte scan reuses the AVX2 path (implied by avx512f)
+#define VB 32
+#define V_BYTE_EQ2_MASK(p, a, b) csv_mask_m256i(_mm256_loadu_si256((const __m256i*)(p)), (a), (b))
+#include "ann_simd_x86_kernels.inc"
+
+// ============================================================================
+// Runtime dispatch
+// The SSE2 table is always valid, so calls made before the load-time
+// constructor has run still work. ANN_SIMD_ISA=sse2|avx2|avx512 caps the
+// selected instruction set (useful for benchmarking the narrower backends).
+// ============================================================================
+static const SimdKernels* kernels = &kernels_sse2;
+
+// Read the OS-enabled register state mask (XCR0)
+static unsigned long long read_xcr0(void) {
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+}
+
+// Detect the widest instruction set supported by both the CPU and the OS
+static const SimdKernels* detect_kernels(void) {
+    unsigned int eax, ebx, ecx, edx;
+    int has_avx2 = 0, has_avx512 = 0;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        int has_osxsave = (ecx & bit_OSXSAVE) != 0;
+        int has_fma = (ecx & bit_FMA) != 0;
+        int has_avx = (ecx & bit_AVX) != 0;
+
+        if (has_osxsave && has_avx && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            unsigned long long xcr0 = read_xcr0();
+            int ymm_enabled = (xcr0 & 0x06) == 0x06;   // XMM + YMM state
+            int zmm_enabled = (xcr0 & 0xE6) == 0xE6;   // + opmask, ZMM_Hi256, Hi16_ZMM
+
+            has_avx2 = ymm_enabled && has_fma && (ebx & bit_AVX2) != 0;
+            has_avx512 = zmm_enabled && (ebx & bit_AVX512F) != 0;
+        }
+    }
+
+    const char* cap = getenv("ANN_SIMD_ISA");
+    if (cap != NULL) {
+        if (strcmp(cap, "sse2") == 0) {
+            has_avx2 = has_avx512 = 0;
+        } else if (strcmp(cap, "avx2") == 0) {
+            has_avx512 = 0;
+        }
+    }
+
+    if (has_avx512) return &kernels_avx512;
+    if (has_avx2) return &kernels_avx2;
+    return &kernels_sse2;
+}
+
+__attribute__((constructor))
+static void init_simd_dispatch(void) {
+    kernels = detect_kernels();
+}
+
+// Name of the selected backend ("sse2", "avx2" or "avx512")
+const char* simd_backend_name(void) {
+    return kernels->name;
+}
+
+// ============================================================================
+// Public kernel API (same signatures as ann_simd.c)
+// ============================================================================
+float dot_product(float* vec1, float* vec2, int length) {
+    return kernels->dot_product(vec1, vec2, length);
+}
+
+// sigmoid: 1 / (1 + e^(-x)) with fast paths for extreme values
+float sigmoid(float x) {
+    if (x < -10.0f) return 0.0f;
+    if (x > 10.0f) return 1.0f;
+
+    float exp_neg_x = expf(-x);
+    return 1.0f / (1.0f + exp_neg_x);
+}
+
+// sigmoid_derivative: sigmoid(x) * (1 - sigmoid(x)) from a sigmoid output
+float sigmoid_derivative(float sigmoid_out) {
+    return sigmoid_out * (1.0f - sigmoid_out);
+}
+
+void relu_forward_simd(float* input, float* output, int length) {
+    kernels->relu_forward_simd(input, output, length);
+}
+
+void relu_backward_simd(float* input, float* grad_output, float* grad_input, int length) {
+    kernels->relu_backward_simd(input, grad_output, grad_input, length);
+}
+
+void tanh_forward_simd(float* input, float* output, int length) {
+    kernels->tanh_forward_simd(input, output, length);
+}
+
+void tanh_backward_simd(float* output, float* grad_output, float* grad_input, int length) {
+    kernels->tanh_backward_simd(output, grad_output, grad_input, length);
+}
+
+void sigmoid_forward_simd(float* input, float* output, int length) {
+    kernels->sigmoid_forward_simd(input, output, length);
+}
+
+void sigmoid_backward_simd(float* output, float* grad_output, float* grad_input, int length) {
+    kernels->sigmoid_backward_simd(output, grad_output, grad_input, length);
+}
+
+void update_weights(float* weights, float* gradients, float lr, int length) {
+    kernels->update_weights(weights, gradients, lr, length);
+}
+
+void dense_forward_simd(float* input, float* weights, float* bias, float* output,
+                        int n_in, int n_out, int activation_type) {
+    kernels->dense_forward_simd(input, weights, bias, output, n_in, n_out, activation_type);
+}
+
+void dense_forward_batch_simd(float* inputs, float* weights, float* bias, float* outputs,
+                              int n_rows, int n_in, int n_out, int activation_type) {
+    kernels->dense_forward_batch_simd(inputs, weights, bias, outputs, n_rows, n_in, n_out, activation_type);
+}
+
+void dense_backward_weights_simd(float* inputs, float* deltas, float* grad_weights, float* grad_bias,
+                                 int n_rows, int n_in, int n_out) {
+    kernels->dense_backward_weights_simd(inputs, deltas, grad_weights, grad_bias, n_rows, n_in, n_out);
+}
+
+void dense_backward_input_simd(float* deltas, float* weights, float* grad_inputs,
+                               int n_rows, int n_in, int n_out) {
+    kernels->dense_backward_input_simd(deltas, weights, grad_inputs, n_rows, n_in, n_out);
+}
+
+void outer_product_update_simd(float* weights, float* bias, float* x, float* delta,
+                               float lr, int n_in, int n_out) {
+    kernels->outer_product_update_simd(weights, bias, x, delta, lr, n_in, n_out);
+}
+
+void momentum_update_simd(float* weights, float* gradients, float* velocity,
+                          float lr, float beta, int length) {
+    kernels->momentum_update_simd(weights, gradients, velocity, lr, beta, length);
+}
+
+void rmsprop_update_simd(float* weights, float* gradients, float* sq_avg,
+                         float lr, float rho, float eps, int length) {
+    kernels->rmsprop_update_simd(weights, gradients, sq_avg, lr, rho, eps, length);
+}
+
+void adam_update_simd(float* weights, float* gradients, float* m, float* v,
+                      float lr, float beta1, float beta2, float eps,
+                      float m_scale, float v_scale, int length) {
+    kernels->adam_update_simd(weights, gradients, m, v, lr, beta1, beta2, eps, m_scale, v_scale, length);
+}
+
+int find_csv_delimiters_simd(const char* data, int length, int* positions) {
+    return kernels->find_csv_delimiters_simd(data, length, positions);
+}
+
+void column_stats_simd(float* data, int n_rows, int n_cols,
+                       float* mean, float* variance, float* min, float* max) {
+    kernels->column_stats_simd(data, n_rows, n_cols, mean, variance, min, max);
+}
+
+void affine_columns_simd(float* data, int n_rows, int n_cols, const float* offset, const float* scale) {
+    kernels->affine_columns_simd(data, n_rows, n_cols, offset, scale);
+}
+
+void softmax_forward_simd(float* logits, float* probs, int n_rows, int n_classes) {
+    kernels->softmax_forward_simd(logits, probs, n_rows, n_classes);
+}
+
+float softmax_cross_entropy_backward_simd(float* probs, const float* labels, float* deltas,
+                                          int n_rows, int n_classes) {
+    return kernels->softmax_cross_entropy_backward_simd(probs, labels, deltas, n_rows, n_classes);
+}
+
+void argmax_rows_simd(float* values, int n_rows, int n_cols, int* indices) {
+    kernels->argmax_rows_simd(values, n_rows, n_cols, indices);
+}
@@ -1,7 +1,29 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+// Native builds (build_native.sh) export symbols from the shared library as-is
+#define EMSCRIPTEN_KEEPALIVE
+#endif
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef ANN_ENABLE_THREADS
+// Threaded builds (build_native.sh, build_threads.sh) compile with -pthread
+#include <pthread.h>
+#endif
+#if !defined(__EMSCRIPTEN__) && !defined(_WIN32)
+// Native POSIX builds can memory-map model files (map_model_file)
+#define ANN_HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // Assembly function declarations
 extern float dot_product(float* vec1, float* vec2, int length);
@@ -14,196 +36,761 @@ extern void relu_forward_simd(float* input, float* output, int length);
 extern void relu_backward_simd(float* input, float* grad_output, float* grad_input, int length);
 extern void tanh_forward_simd(float* input, float* output, int length);
 extern void tanh_backward_simd(float* output, float* grad_output, float* grad_input, int length);
+extern void sigmoid_forward_simd(float* input, float* output, int length);
+extern void sigmoid_backward_simd(float* output, float* grad_output, float* grad_input, int length);
+
+// Fused dense layer kernel (GEMV + bias + activation)
+extern void dense_forward_simd(float* input, float* weights, float* bias, float* output,
+                               int n_in, int n_out, int activation_type);
+
+// Mini-batch GEMM kernels (forward pass and gradient accumulation)
+extern void dense_forward_batch_simd(float* inputs, float* weights, float* bias, float* outputs,
+                                     int n_rows, int n_in, int n_out, int activation_type);
+extern void dense_backward_weights_simd(float* inputs, float* deltas, float* grad_weights, float* grad_bias,
+                                        int n_rows, int n_in, int n_out);
+extern void dense_backward_input_simd(float* deltas, float* weights, float* grad_inputs,
+                                      int n_rows, int n_in, int n_out);
+
+// Rank-1 weight update kernel (per-sample SGD)
+extern void outer_product_update_simd(float* weights, float* bias, float* x, float* delta,
+                                      float lr, int n_in, int n_out);
+
+// Optimizer state update kernels
+extern void momentum_update_simd(float* weights, float* gradients, float* velocity,
+                                 float lr, float beta, int length);
+extern void rmsprop_update_simd(float* weights, float* gradients, float* sq_avg,
+                                float lr, float rho, float eps, int length);
+extern void adam_update_simd(float* weights, float* gradients, float* m, float* v,
+                             float lr, float beta1, float beta2, float eps,
+                             float m_scale, float v_scale, int length);
+
+// Feature statistics and normalization kernels
+extern void column_stats_simd(float* data, int n_rows, int n_cols,
+                              float* mean, float* variance, float* min, float* max);
+extern void affine_columns_simd(float* data, int n_rows, int n_cols, const float* offset, const float* scale);
+
+// Softmax classifier head kernels
+extern void softmax_forward_simd(float* logits, float* probs, int n_rows, int n_classes);
+extern float softmax_cross_entropy_backward_simd(float* probs, const float* labels, float* deltas,
+                                                 int n_rows, int n_classes);
+extern void argmax_rows_simd(float* values, int n_rows, int n_cols, int* indices);
+
+// Optimizer selection for train_ann_v4
+#define OPTIMIZER_SGD      0
+#define OPTIMIZER_MOMENTUM 1
+#define OPTIMIZER_RMSPROP  2
+#define OPTIMIZER_ADAM     3
+
+// Optimizer hyperparameters (common defaults)
+#define MOMENTUM_BETA  0.9f
+#define RMSPROP_RHO    0.9f
+#define ADAM_BETA1     0.9f
+#define ADAM_BETA2     0.999f
+#define OPTIMIZER_EPS  1e-8f
+
+// Upper bound on data-parallel training threads (one BatchWorkspace each)
+#define MAX_TRAIN_THREADS 64
+
+// Largest input and hidden layers accepted by validate_training_config and
+// validate_network_shape (inference scratch is sized for these)
+#define MAX_INPUT_FEATURES 1024
+#define MAX_HIDDEN_NEURONS 1024
+
+// Most dense layers in a network, output layer included
+#define MAX_LAYERS 8
+
+// Output layer activation of classifiers: the dense kernels leave the logits
+// as they are (identity), then softmax_forward_simd turns them into class
+// probabilities. Only valid on the output layer, with 2-1024 classes.
+#define ACTIVATION_SOFTMAX 3
+#define MAX_OUTPUT_CLASSES 1024
+
+// Input normalization methods (normalize_columns, set_network_normalization)
+#define NORMALIZE_NONE   0
+#define NORMALIZE_ZSCORE 1  // (x - mean) / standard deviation
+#define NORMALIZE_MINMAX 2  // (x - min) / (max - min), maps to [0, 1]
+
+// Rows per block of the batched forward pass (run_ann_batch, classify_batch)
+#define RUN_BATCH_ROWS 64
+
+// Network architecture: n_layers dense layers, the last one being the output
+// layer. Layer l maps the previous layer's units (n_inputs for layer 0) to
+// sizes[l] units with activations[l] (0=sigmoid, 1=relu, 2=tanh, and
+// 3=softmax for a classifier's output layer).
+typedef struct {
+    int n_inputs;
+    int n_layers;
+    int sizes[MAX_LAYERS];
+    int activations[MAX_LAYERS];
+} NetworkShape;
+
+// One dense layer of a network
+typedef struct {
+    int n_in;            // Units feeding the layer
+    int n_out;           // Units in the layer
+    int activation;      // 0=sigmoid, 1=relu, 2=tanh, 3=softmax (output layer only)
+    int unit_offset;     // Offset of the layer's units in the scratch buffers
+    float* weights;      // [n_in][n_out] (input-major), inside the parameter block
+    float* bias;         // [n_out], follows weights
+} DenseLayer;
+
+// Mini-batch scratch buffers (carved from the network workspace arena).
+// Layer l's rows start at capacity * layers[l].unit_offset.
+typedef struct {
+    int capacity;        // Maximum rows per batch (0 = no batch buffers)
+    float* activations;  // Layer activations: [capacity][n_out] per layer
+    float* deltas;       // Layer deltas: [capacity][n_out] per layer
+    float* grads;        // Parameter gradients [n_params], same layout as the parameters
+} BatchWorkspace;
+
+// Per-sample scratch buffers for compute_forward_pass / compute_backward_pass.
+// Layer l's units start at layers[l].unit_offset.
+typedef struct {
+    float* activations;  // Layer activations [n_units]
+    float* deltas;       // Layer deltas [n_units]
+} SampleScratch;
+
+// Resumable mini-batch training run (train_network_begin / train_network_run_*
+// / train_network_finish), kept in the model handle between calls
+typedef struct {
+    int active;          // A run is in progress
+    float* inputs;       // Caller-owned training rows (alive until the run is finished)
+    float* outputs;
+    int n_rows;
+    int batch_size;
+    int optimizer;
+    float learning_rate;
+    int epochs;          // Epochs requested
+    int epoch;           // Epochs completed
+    int row;             // First row of the next mini-batch in the current epoch
+    float epoch_loss;    // Loss summed over the current epoch so far
+    float final_loss;    // Mean loss of the last completed epoch
+    float* loss_history;
+} TrainSession;
 
 // Neural Network structure
 typedef struct {
-    int n_inputs;        // 1-10
-    int n_hidden;        // 2-20 (configurable)
-    int n_outputs;       // Always 1
+    int n_inputs;        // 1-1024
+    int n_outputs;       // 1 (sigmoid output) or the class count (softmax output)
+    int n_layers;        // Dense layers including the output layer (2 = one hidden layer)
+    int n_units;         // Units over all layers
+    int max_width;       // Widest of the input and layer widths
+    DenseLayer layers[MAX_LAYERS];
     
-    float* weights_ih;   // Input to hidden: [n_inputs * n_hidden]
-    float* weights_ho;   // Hidden to output: [n_hidden * n_outputs]
-    float* bias_h;       // Hidden biases: [n_hidden]
-    float* bias_o;       // Output bias: [n_outputs]
+    // Parameters, stored contiguously as [weights, bias] per layer in order so
+    // optimizers can treat them (and the matching BatchWorkspace gradients) as
+    // one flat vector
+    float* params;       // Parameter block [n_params]
+    int n_params;        // Total parameter count
+    int params_borrowed; // Parameters are a view of caller memory or a file mapping (not freed)
+    void* mapping;       // Model file mapping owned by the network (map_model_file)
+    size_t mapping_size; // Length of mapping in bytes
     
-    float* hidden_activations;  // Temporary storage
-    float* output_activation;   // Temporary storage
+    // Input transform applied by the inference entry points before the first
+    // layer: x' = (x - input_offset) * input_scale. Cleared by training.
+    int normalization;   // NORMALIZE_*
+    float input_offset[MAX_INPUT_FEATURES];
+    float input_scale[MAX_INPUT_FEATURES];
+    
+    // Optimizer moment buffers [n_params] (NULL when the optimizer needs none).
+    // They persist between training calls so continued training
+    // (train_network_epochs / train_network_step) resumes where it stopped.
+    float* opt_m;        // Momentum velocity / Adam first moment
+    float* opt_v;        // RMSProp / Adam second moment
+    int optimizer;       // OPTIMIZER_* the moment buffers belong to
+    int opt_step;        // Optimizer steps taken so far (Adam bias correction)
+    
+    // Scratch buffers, all carved from one workspace arena sized in init_network
+    SampleScratch sample;       // Per-sample training buffers
+    BatchWorkspace batch[MAX_TRAIN_THREADS];  // Mini-batch buffers, one per training thread
+    int n_batch_workspaces;     // Number of valid entries in batch
+    float* workspace;           // Arena base (single allocation)
+    TrainSession session;       // Resumable training run, if one is in progress
     
-    int activation_type;  // 0=sigmoid, 1=relu, 2=tanh
     int is_initialized;  // Flag to check if network is trained
+    int warm_start;      // Retraining keeps the weights when the architecture is unchanged
+    unsigned int seed;   // Weight initialization RNG state
 } NeuralNetwork;
 
-// Global network instance
-static NeuralNetwork network = {0};
+// Caller-owned inference scratch. run_network_ctx only reads the model and
+// writes only here, so threads scoring concurrently each need their own.
+typedef struct {
+    float input[MAX_INPUT_FEATURES];      // Normalized input
+    float layer[2][MAX_HIDDEN_NEURONS];   // Alternating layer activations
+} InferenceContext;
+
+// Default model behind the handle-less exports (train_ann, run_ann, ...).
+// Additional models are created with create_network.
+static NeuralNetwork default_network = {.seed = 12345};
 
-// Simple random number generator for weight initialization
-static unsigned int seed = 12345;
+// Heap allocation counter: every allocation made by this module goes through
+// ann_malloc, so callers can check that training and inference allocate nothing
+// beyond the fixed set made in init_network (the batch scoring calls add one
+// block buffer per call). Atomic, since networks may be created and trained
+// on several threads at once.
+static int alloc_count = 0;
 
-static float rand_float() {
-    seed = seed * 1103515245 + 12345;
-    return ((seed / 65536) % 32768) / 32768.0f;
+static void* ann_malloc(size_t size) {
+    __atomic_fetch_add(&alloc_count, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+// Simple random number generator for weight initialization (per network, so
+// models trained on different threads never share RNG state)
+static float rand_float(NeuralNetwork* net) {
+    net->seed = net->seed * 1103515245 + 12345;
+    return ((net->seed / 65536) % 32768) / 32768.0f;
 }
 
 // Xavier/Glorot initialization: uniform distribution in [-limit, limit]
-static float xavier_init(int n_in, int n_out) {
+static float xavier_init(NeuralNetwork* net, int n_in, int n_out) {
     float limit = sqrtf(6.0f / (n_in + n_out));
-    return (rand_float() * 2.0f - 1.0f) * limit;
+    return (rand_float(net) * 2.0f - 1.0f) * limit;
 }
 
-// Initialize network with given dimensions and activation type
-static void init_network(int n_inputs, int n_hidden, int n_outputs, int activation_type) {
-    // Free existing memory if network was previously initialized
-    if (network.is_initialized) {
-        free(network.weights_ih);
-        free(network.weights_ho);
-        free(network.bias_h);
-        free(network.bias_o);
-        free(network.hidden_activations);
-        free(network.output_activation);
+// The classic architecture: one hidden layer, one sigmoid output
+static NetworkShape single_hidden_shape(int n_inputs, int n_hidden, int activation_type) {
+    NetworkShape shape;
+    memset(&shape, 0, sizeof(shape));
+    shape.n_inputs = n_inputs;
+    shape.n_layers = 2;
+    shape.sizes[0] = n_hidden;
+    shape.activations[0] = activation_type;
+    shape.sizes[1] = 1;
+    shape.activations[1] = 0;
+    return shape;
+}
+
+// Number of floats in one BatchWorkspace, rounded up to a 64-byte multiple so
+// workspaces used by different threads never share a cache line
+static size_t batch_workspace_floats(int n_units, int n_params, int batch_capacity) {
+    size_t floats = (size_t)batch_capacity * 2 * n_units + n_params;
+    return (floats + 15) & ~(size_t)15;
+}
+
+// Number of floats needed for the workspace arena
+static size_t workspace_floats(int n_units, int n_params, int batch_capacity, int n_batch_workspaces) {
+    size_t per_sample = ((size_t)2 * n_units + 15) & ~(size_t)15;
+    size_t batch = 0;
+    if (batch_capacity > 0) {
+        batch = n_batch_workspaces * batch_workspace_floats(n_units, n_params, batch_capacity);
+    }
+    return per_sample + batch;
+}
+
+// Point the scratch buffers into the workspace arena
+static void layout_workspace(NeuralNetwork* net, float* arena, int batch_capacity, int n_batch_workspaces) {
+    int n_units = net->n_units;
+    
+    net->sample.activations = arena;
+    net->sample.deltas = arena + n_units;
+    
+    memset(net->batch, 0, sizeof(net->batch));
+    net->n_batch_workspaces = 0;
+    if (batch_capacity <= 0) {
+        return;
     }
     
-    // Set dimensions
-    network.n_inputs = n_inputs;
-    network.n_hidden = n_hidden;
-    network.n_outputs = n_outputs;
-    network.activation_type = activation_type;
+    float* block = arena + (((size_t)2 * n_units + 15) & ~(size_t)15);
+    size_t stride = batch_workspace_floats(n_units, net->n_params, batch_capacity);
+    for (int t = 0; t < n_batch_workspaces; t++) {
+        BatchWorkspace* ws = &net->batch[t];
+        ws->capacity = batch_capacity;
+        ws->activations = block + t * stride;
+        ws->deltas = ws->activations + (size_t)batch_capacity * n_units;
+        ws->grads = ws->deltas + (size_t)batch_capacity * n_units;
+    }
+    net->n_batch_workspaces = n_batch_workspaces;
+}
+
+// Release the parameter, optimizer and workspace blocks of a network
+static void free_network_buffers(NeuralNetwork* net) {
+    if (!net->params_borrowed) {
+        free(net->params);
+    }
+#ifdef ANN_HAVE_MMAP
+    if (net->mapping != NULL) {
+        munmap(net->mapping, net->mapping_size);
+    }
+#endif
+    free(net->opt_m);
+    free(net->workspace);
+    net->params = NULL;
+    net->params_borrowed = 0;
+    net->mapping = NULL;
+    net->mapping_size = 0;
+    net->opt_m = NULL;
+    net->opt_v = NULL;
+    net->workspace = NULL;
+    net->session.active = 0;
+    net->is_initialized = 0;
+}
+
+// Initialize a network with the given (validated) architecture.
+// batch_capacity reserves n_batch_workspaces sets of mini-batch buffers for up
+// to that many rows each (0 = none). params_view, if not NULL, is used as the
+// parameter block in place (not copied, initialized or freed); otherwise a
+// block is allocated and Xavier-initialized. On allocation failure
+// net->workspace is left NULL (and, if the parameter block could not be
+// allocated, the network is left untrained).
+static void init_network(NeuralNetwork* net, const NetworkShape* shape,
+                         int batch_capacity, int n_batch_workspaces, float* params_view) {
+    // Free existing memory if network was previously initialized
+    if (net->is_initialized) {
+        free_network_buffers(net);
+    }
     
-    // Allocate memory for weights and biases
-    network.weights_ih = (float*)malloc(n_inputs * n_hidden * sizeof(float));
-    network.weights_ho = (float*)malloc(n_hidden * n_outputs * sizeof(float));
-    network.bias_h = (float*)malloc(n_hidden * sizeof(float));
-    network.bias_o = (float*)malloc(n_outputs * sizeof(float));
+    // Set dimensions: each layer's weights and bias follow the previous layer's
+    net->n_inputs = shape->n_inputs;
+    net->n_layers = shape->n_layers;
+    net->n_outputs = shape->sizes[shape->n_layers - 1];
+    net->normalization = NORMALIZE_NONE;
+    net->optimizer = OPTIMIZER_SGD;
+    net->opt_step = 0;
+    net->n_units = 0;
+    net->n_params = 0;
+    net->max_width = shape->n_inputs;
+    for (int l = 0; l < shape->n_layers; l++) {
+        DenseLayer* layer = &net->layers[l];
+        layer->n_in = l == 0 ? shape->n_inputs : shape->sizes[l - 1];
+        layer->n_out = shape->sizes[l];
+        layer->activation = shape->activations[l];
+        layer->unit_offset = net->n_units;
+        net->n_units += layer->n_out;
+        net->n_params += layer->n_in * layer->n_out + layer->n_out;
+        if (layer->n_out > net->max_width) {
+            net->max_width = layer->n_out;
+        }
+    }
     
-    // Allocate temporary activation buffers
-    network.hidden_activations = (float*)malloc(n_hidden * sizeof(float));
-    network.output_activation = (float*)malloc(n_outputs * sizeof(float));
+    // Allocate one block for all weights and biases (or borrow the view)
+    net->params_borrowed = params_view != NULL;
+    net->params = params_view != NULL ? params_view : (float*)ann_malloc(net->n_params * sizeof(float));
+    if (net->params == NULL) {
+        // Leave the network untrained; callers see workspace == NULL (-6)
+        net->workspace = NULL;
+        net->is_initialized = 0;
+        return;
+    }
+    float* block = net->params;
+    for (int l = 0; l < net->n_layers; l++) {
+        DenseLayer* layer = &net->layers[l];
+        layer->weights = block;
+        layer->bias = layer->weights + layer->n_in * layer->n_out;
+        block = layer->bias + layer->n_out;
+    }
     
-    // Initialize input-to-hidden weights using Xavier initialization
-    for (int i = 0; i < n_inputs * n_hidden; i++) {
-        network.weights_ih[i] = xavier_init(n_inputs, n_hidden);
+    // Allocate the workspace arena holding every scratch buffer
+    size_t arena_floats = workspace_floats(net->n_units, net->n_params, batch_capacity, n_batch_workspaces);
+    net->workspace = (float*)ann_malloc(arena_floats * sizeof(float));
+    if (net->workspace != NULL) {
+        layout_workspace(net, net->workspace, batch_capacity, n_batch_workspaces);
     }
     
-    // Initialize hidden-to-output weights using Xavier initialization
-    for (int i = 0; i < n_hidden * n_outputs; i++) {
-        network.weights_ho[i] = xavier_init(n_hidden, n_outputs);
+    net->is_initialized = 1;
+    if (params_view != NULL) {
+        return;
     }
     
-    // Initialize biases to zero
-    memset(network.bias_h, 0, n_hidden * sizeof(float));
-    memset(network.bias_o, 0, n_outputs * sizeof(float));
+    for (int l = 0; l < net->n_layers; l++) {
+        DenseLayer* layer = &net->layers[l];
     
-    network.is_initialized = 1;
+        // Xavier-initialized weights (drawn output-major, stored input-major)
+        for (int j = 0; j < layer->n_out; j++) {
+            for (int i = 0; i < layer->n_in; i++) {
+                layer->weights[i * layer->n_out + j] = xavier_init(net, layer->n_in, layer->n_out);
+            }
+        }
+    
+        // Initialize biases to zero
+        memset(layer->bias, 0, layer->n_out * sizeof(float));
+    }
+}
+
+// Validate a layer stack: 1-1024 inputs, 2..MAX_LAYERS layers, hidden layers of
+// 2-1024 units with activation 0-2, and either one sigmoid output unit or a
+// softmax output layer of 2-1024 classes.
+// Returns 0, -1 invalid input size, -2 invalid hidden layer size, -3 invalid
+// activation type, -15 invalid layer count or output layer.
+static int validate_network_shape(const NetworkShape* shape) {
+    if (shape->n_inputs < 1 || shape->n_inputs > MAX_INPUT_FEATURES) {
+        return -1; // Error: invalid input size
+    }
+    if (shape->n_layers < 2 || shape->n_layers > MAX_LAYERS) {
+        return -15; // Error: invalid layer configuration
+    }
+    for (int l = 0; l < shape->n_layers - 1; l++) {
+        if (shape->sizes[l] < 2 || shape->sizes[l] > MAX_HIDDEN_NEURONS) {
+            return -2; // Error: invalid hidden layer size
+        }
+        if (shape->activations[l] < 0 || shape->activations[l] > 2) {
+            return -3; // Error: invalid activation type
+        }
+    }
+    int n_outputs = shape->sizes[shape->n_layers - 1];
+    int output_activation = shape->activations[shape->n_layers - 1];
+    int sigmoid_output = n_outputs == 1 && output_activation == 0;
+    int softmax_output = n_outputs >= 2 && n_outputs <= MAX_OUTPUT_CLASSES &&
+                         output_activation == ACTIVATION_SOFTMAX;
+    if (!sigmoid_output && !softmax_output) {
+        return -15; // Error: invalid layer configuration
+    }
+    return 0;
+}
+
+// Shared parameter validation for the configurable training and model loading entry points
+static float validate_training_config(int n_rows, int n_inputs, int n_hidden, int activation_type) {
+    NetworkShape shape = single_hidden_shape(n_inputs, n_hidden, activation_type);
+    int shape_error = validate_network_shape(&shape);
+    if (shape_error < 0) {
+        return (float)shape_error;
+    }
+    if (n_rows < 1) {
+        return -4.0f; // Error: invalid number of rows
+    }
+    return 0.0f;
 }
 
-// Activation function dispatcher for forward pass
-static void apply_activation(float* input, float* output, int length, int activation_type) {
+// Activation forward dispatcher: in place over a whole vector
+static void apply_activation_forward(float* values, int length, int activation_type) {
     switch (activation_type) {
-        case 0: // Sigmoid
-            for (int i = 0; i < length; i++) {
-                output[i] = sigmoid(input[i]);
-            }
-            break;
         case 1: // ReLU
-            relu_forward_simd(input, output, length);
+            relu_forward_simd(values, values, length);
             break;
         case 2: // Tanh
-            tanh_forward_simd(input, output, length);
+            tanh_forward_simd(values, values, length);
             break;
-        default:
-            // Default to sigmoid if invalid type
-            for (int i = 0; i < length; i++) {
-                output[i] = sigmoid(input[i]);
-            }
+        default: // Sigmoid
+            sigmoid_forward_simd(values, values, length);
             break;
     }
 }
 
-// Activation derivative dispatcher for backward pass
-static float apply_activation_derivative(float activation_output, int activation_type) {
+// Forward pass of one dense layer for a single sample
+static void layer_forward(const DenseLayer* layer, float* input, float* output) {
+    if (layer->n_out == 1) {
+        // Single-output layers: one dot product, as dense_forward_batch_simd
+        output[0] = dot_product(input, layer->weights, layer->n_in) + layer->bias[0];
+        apply_activation_forward(output, 1, layer->activation);
+    } else {
+        // Fused weighted sums, bias and activation (logits for softmax)
+        dense_forward_simd(input, layer->weights, layer->bias, output,
+                           layer->n_in, layer->n_out, layer->activation);
+        if (layer->activation == ACTIVATION_SOFTMAX) {
+            softmax_forward_simd(output, output, 1, layer->n_out);
+        }
+    }
+}
+
+// Forward pass of one dense layer for n_rows samples (row-major)
+static void layer_forward_batch(const DenseLayer* layer, float* inputs, float* outputs, int n_rows) {
+    dense_forward_batch_simd(inputs, layer->weights, layer->bias, outputs,
+                             n_rows, layer->n_in, layer->n_out, layer->activation);
+    if (layer->activation == ACTIVATION_SOFTMAX) {
+        softmax_forward_simd(outputs, outputs, n_rows, layer->n_out);
+    }
+}
+
+#ifndef ANN_INFERENCE_ONLY
+// Training (everything up to the handle API) is compiled out of the
+// inference-only build (build_inference.sh)
+
+// Forward propagation: compute every layer's activations for given input into
+// scratch. Returns the output layer activations.
+static float* compute_forward_pass(const NeuralNetwork* net, float* input, SampleScratch* scratch) {
+    for (int l = 0; l < net->n_layers; l++) {
+        float* output = scratch->activations + net->layers[l].unit_offset;
+        layer_forward(&net->layers[l], input, output);
+        input = output;
+    }
+    return input;
+}
+
+// Activation backward dispatcher: grad *= activation'(x), in place over a whole vector
+static void apply_activation_backward(float* activations, float* grad, int length, int activation_type) {
     switch (activation_type) {
-        case 0: // Sigmoid
-            return sigmoid_derivative(activation_output);
-        case 1: // ReLU
-            return (activation_output > 0.0f) ? 1.0f : 0.0f;
+        case 1: // ReLU (output > 0 exactly where input > 0)
+            relu_backward_simd(activations, grad, grad, length);
+            break;
         case 2: // Tanh
-            return 1.0f - activation_output * activation_output;
-        default:
-            return sigmoid_derivative(activation_output);
+            tanh_backward_simd(activations, grad, grad, length);
+            break;
+        default: // Sigmoid
+            sigmoid_backward_simd(activations, grad, grad, length);
+            break;
+    }
+}
+
+// Backward propagation: compute gradients and update weights
+// (scratch holds the activations from the matching compute_forward_pass)
+static void compute_backward_pass(NeuralNetwork* net, float* input, float target, float learning_rate,
+                                  SampleScratch* scratch) {
+    const DenseLayer* output_layer = &net->layers[net->n_layers - 1];
+    float* output = scratch->activations + output_layer->unit_offset;
+    
+    // Compute output layer delta (output always uses sigmoid)
+    float error = output[0] - target;
+    sigmoid_backward_simd(output, &error, scratch->deltas + output_layer->unit_offset, 1);
+    
+    // Walk the layers from the output back. Each layer's delta is propagated
+    // to the layer below through its weights before they are updated.
+    for (int l = net->n_layers - 1; l >= 0; l--) {
+        DenseLayer* layer = &net->layers[l];
+        float* delta = scratch->deltas + layer->unit_offset;
+        float* layer_input = input;
+    
+        if (l > 0) {
+            // Back-propagate through the weights, then scale by the previous
+            // layer's activation derivative (whole-vector SIMD steps)
+            const DenseLayer* below = &net->layers[l - 1];
+            layer_input = scratch->activations + below->unit_offset;
+            float* below_delta = scratch->deltas + below->unit_offset;
+            dense_backward_input_simd(delta, layer->weights, below_delta, 1, layer->n_in, layer->n_out);
+            apply_activation_backward(layer_input, below_delta, layer->n_in, below->activation);
+        }
+    
+        // Rank-1 update: W -= lr * x (outer) delta, bias included
+        outer_product_update_simd(layer->weights, layer->bias, layer_input, delta,
+                                  learning_rate, layer->n_in, layer->n_out);
     }
 }
 
-// Forward propagation: compute network output for given input
-static void compute_forward_pass(float* input) {
-    // Temporary buffer for pre-activation values
-    float* z_h = (float*)malloc(network.n_hidden * sizeof(float));
+// Forward and backward pass over one mini-batch: overwrites the gradient
+// buffer in ws with gradients summed over the batch rows.
+// Returns the summed loss of the batch (computed before any update): squared
+// error for a sigmoid output, cross-entropy for a softmax output, whose
+// targets are class indices.
+static float compute_batch_gradients(NeuralNetwork* net, BatchWorkspace* ws, float* inputs, float* targets,
+                                     int n_rows) {
+    int last = net->n_layers - 1;
     
-    // Input to hidden layer
-    for (int h = 0; h < network.n_hidden; h++) {
-        // Get weights for this hidden neuron
-        float* weights_slice = &network.weights_ih[h * network.n_inputs];
-        
-        // Compute weighted sum using assembly dot product
-        z_h[h] = dot_product(input, weights_slice, network.n_inputs);
-        z_h[h] += network.bias_h[h];
+    // Forward pass: one [n_rows x n_in] x [n_in x n_out] GEMM per layer
+    float* layer_input = inputs;
+    for (int l = 0; l <= last; l++) {
+        DenseLayer* layer = &net->layers[l];
+        float* activations = ws->activations + (size_t)ws->capacity * layer->unit_offset;
+        layer_forward_batch(layer, layer_input, activations, n_rows);
+        layer_input = activations;
     }
     
-    // Apply activation function to hidden layer
-    apply_activation(z_h, network.hidden_activations, network.n_hidden, network.activation_type);
+    // Output deltas and loss
+    float* output = layer_input;
+    float* delta_o = ws->deltas + (size_t)ws->capacity * net->layers[last].unit_offset;
+    float batch_loss = 0.0f;
+    if (net->layers[last].activation == ACTIVATION_SOFTMAX) {
+        // Softmax with cross-entropy: delta = p - onehot(target), no Jacobian
+        batch_loss = softmax_cross_entropy_backward_simd(output, targets, delta_o, n_rows, net->n_outputs);
+    } else {
+        // Sigmoid unit with squared error
+        for (int r = 0; r < n_rows; r++) {
+            float error = output[r] - targets[r];
+            delta_o[r] = error;
+            batch_loss += error * error;
+        }
+        sigmoid_backward_simd(output, delta_o, delta_o, n_rows);
+    }
     
-    free(z_h);
+    // Back-propagate the deltas layer by layer: delta_below = delta * W^T,
+    // scaled by the activation derivative of the layer below
+    for (int l = last; l > 0; l--) {
+        DenseLayer* layer = &net->layers[l];
+        DenseLayer* below = &net->layers[l - 1];
+        float* delta = ws->deltas + (size_t)ws->capacity * layer->unit_offset;
+        float* below_delta = ws->deltas + (size_t)ws->capacity * below->unit_offset;
+        float* below_activations = ws->activations + (size_t)ws->capacity * below->unit_offset;
+        dense_backward_input_simd(delta, layer->weights, below_delta, n_rows, layer->n_in, layer->n_out);
+        apply_activation_backward(below_activations, below_delta, n_rows * layer->n_in, below->activation);
+    }
     
-    // Hidden to output layer
-    for (int o = 0; o < network.n_outputs; o++) {
-        // Compute weighted sum using assembly dot product
-        float z_o = dot_product(network.hidden_activations, network.weights_ho, network.n_hidden);
-        z_o += network.bias_o[o];
-        
-        // Apply sigmoid activation (output layer always uses sigmoid)
-        network.output_activation[o] = sigmoid(z_o);
+    // Gradient accumulation: dW = X^T * delta for every layer (the gradient
+    // block mirrors the parameter block)
+    memset(ws->grads, 0, net->n_params * sizeof(float));
+    for (int l = last; l >= 0; l--) {
+        DenseLayer* layer = &net->layers[l];
+        float* x = l > 0 ? ws->activations + (size_t)ws->capacity * net->layers[l - 1].unit_offset : inputs;
+        float* delta = ws->deltas + (size_t)ws->capacity * layer->unit_offset;
+        float* grad_weights = ws->grads + (layer->weights - net->params);
+        float* grad_bias = ws->grads + (layer->bias - net->params);
+        dense_backward_weights_simd(x, delta, grad_weights, grad_bias, n_rows, layer->n_in, layer->n_out);
     }
+    
+    return batch_loss;
 }
 
-// Backward propagation: compute gradients and update weights
-static void compute_backward_pass(float* input, float target, float learning_rate) {
-    // Allocate temporary arrays for deltas
-    float* delta_h = (float*)malloc(network.n_hidden * sizeof(float));
-    float delta_o;
+// Allocate zeroed moment buffers for the selected optimizer
+static int alloc_optimizer_state(NeuralNetwork* net, int optimizer) {
+    net->optimizer = optimizer;
+    net->opt_step = 0;
+    int n_buffers = 0;
+    if (optimizer == OPTIMIZER_MOMENTUM || optimizer == OPTIMIZER_RMSPROP) {
+        n_buffers = 1;
+    } else if (optimizer == OPTIMIZER_ADAM) {
+        n_buffers = 2;
+    }
+    if (n_buffers == 0) {
+        return 1;
+    }
     
-    // Compute output layer delta (output always uses sigmoid)
-    float error = network.output_activation[0] - target;
-    delta_o = error * sigmoid_derivative(network.output_activation[0]);
+    size_t total = (size_t)n_buffers * net->n_params;
+    net->opt_m = (float*)ann_malloc(total * sizeof(float));
+    if (net->opt_m == NULL) {
+        return 0;
+    }
+    memset(net->opt_m, 0, total * sizeof(float));
+    net->opt_v = (n_buffers == 2) ? net->opt_m + net->n_params : net->opt_m;
+    return 1;
+}
+
+// Apply the batch gradients held in ws with the selected optimizer.
+// step counts updates from 1 (used for Adam bias correction).
+static void apply_optimizer_step(NeuralNetwork* net, BatchWorkspace* ws, int optimizer, float learning_rate,
+                                 int step) {
+    float* params = net->params;
+    float* grads = ws->grads;
+    int n = net->n_params;
+    
+    switch (optimizer) {
+        case OPTIMIZER_MOMENTUM:
+            momentum_update_simd(params, grads, net->opt_m, learning_rate, MOMENTUM_BETA, n);
+            break;
+        case OPTIMIZER_RMSPROP:
+            rmsprop_update_simd(params, grads, net->opt_v, learning_rate, RMSPROP_RHO, OPTIMIZER_EPS, n);
+            break;
+        case OPTIMIZER_ADAM: {
+            float m_scale = 1.0f / (1.0f - powf(ADAM_BETA1, (float)step));
+            float v_scale = 1.0f / (1.0f - powf(ADAM_BETA2, (float)step));
+            adam_update_simd(params, grads, net->opt_m, net->opt_v, learning_rate,
+                             ADAM_BETA1, ADAM_BETA2, OPTIMIZER_EPS, m_scale, v_scale, n);
+            break;
+        }
+        default: // Plain SGD
+            update_weights(params, grads, learning_rate, n);
+            break;
+    }
+}
+
+// Whether net holds a model with exactly this architecture
+static int same_architecture(const NeuralNetwork* net, const NetworkShape* shape) {
+    if (!net->is_initialized || net->n_inputs != shape->n_inputs || net->n_layers != shape->n_layers) {
+        return 0;
+    }
+    for (int l = 0; l < shape->n_layers; l++) {
+        if (net->layers[l].n_out != shape->sizes[l] || net->layers[l].activation != shape->activations[l]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Prepare a trained network for more training from its current weights:
+// end any resumable run, copy a borrowed parameter block (load_model_view,
+// map_model_file) into memory the network owns, grow the workspace arena to
+// n_batch_workspaces sets of batch_capacity rows if it is smaller, and keep
+// the optimizer moments if they belong to optimizer (otherwise start them
+// from zero).
+// The weights and the input normalization are kept. Returns 0, or -6 when
+// out of memory (the model is left usable).
+static int continue_training(NeuralNetwork* net, int batch_capacity, int n_batch_workspaces, int optimizer) {
+    // Another training call ends a resumable run (it may resize its buffers)
+    net->session.active = 0;
     
-    // Compute hidden layer deltas using activation derivative dispatcher
-    for (int h = 0; h < network.n_hidden; h++) {
-        float error_h = delta_o * network.weights_ho[h];
-        delta_h[h] = error_h * apply_activation_derivative(network.hidden_activations[h], network.activation_type);
+    // Training writes the parameters
+    if (net->params_borrowed) {
+        float* params = (float*)ann_malloc(net->n_params * sizeof(float));
+        if (params == NULL) {
+            return -6; // Error: out of memory
+        }
+        memcpy(params, net->params, net->n_params * sizeof(float));
+        for (int l = 0; l < net->n_layers; l++) {
+            DenseLayer* layer = &net->layers[l];
+            layer->weights = params + (layer->weights - net->params);
+            layer->bias = params + (layer->bias - net->params);
+        }
+#ifdef ANN_HAVE_MMAP
+        if (net->mapping != NULL) {
+            munmap(net->mapping, net->mapping_size);
+        }
+#endif
+        net->mapping = NULL;
+        net->mapping_size = 0;
+        net->params = params;
+        net->params_borrowed = 0;
     }
     
-    // Update hidden-to-output weights
-    for (int h = 0; h < network.n_hidden; h++) {
-        network.weights_ho[h] -= learning_rate * delta_o * network.hidden_activations[h];
+    // Grow the scratch arena when the batch size or thread count needs more
+    if (batch_capacity > 0 && (net->n_batch_workspaces < n_batch_workspaces ||
+                               net->batch[0].capacity < batch_capacity)) {
+        size_t arena_floats = workspace_floats(net->n_units, net->n_params, batch_capacity, n_batch_workspaces);
+        float* arena = (float*)ann_malloc(arena_floats * sizeof(float));
+        if (arena == NULL) {
+            return -6; // Error: out of memory
+        }
+        free(net->workspace);
+        net->workspace = arena;
+        layout_workspace(net, arena, batch_capacity, n_batch_workspaces);
     }
-    network.bias_o[0] -= learning_rate * delta_o;
     
-    // Update input-to-hidden weights
-    for (int h = 0; h < network.n_hidden; h++) {
-        for (int i = 0; i < network.n_inputs; i++) {
-            network.weights_ih[h * network.n_inputs + i] -= learning_rate * delta_h[h] * input[i];
+    // Moments (and the Adam step count) carry over for the same optimizer
+    if (net->optimizer != optimizer) {
+        free(net->opt_m);
+        net->opt_m = NULL;
+        net->opt_v = NULL;
+        if (!alloc_optimizer_state(net, optimizer)) {
+            return -6; // Error: out of memory
         }
-        network.bias_h[h] -= learning_rate * delta_h[h];
+    }
+    return 0;
+}
+
+// Set up net for a training run on shape (batch buffers as init_network).
+// Normally the model is replaced by a freshly initialized one. With warm
+// start enabled and an unchanged architecture, the current weights and input
+// normalization are kept and only the optimizer state starts from zero.
+// Returns 0, or -6 when out of memory.
+static int begin_training(NeuralNetwork* net, const NetworkShape* shape, int batch_capacity,
+                          int n_batch_workspaces, int optimizer) {
+    if (net->warm_start && same_architecture(net, shape)) {
+        free(net->opt_m);
+        net->opt_m = NULL;
+        net->opt_v = NULL;
+        net->optimizer = OPTIMIZER_SGD;
+        return continue_training(net, batch_capacity, n_batch_workspaces, optimizer);
     }
     
-    free(delta_h);
+    init_network(net, shape, batch_capacity, n_batch_workspaces, NULL);
+    if (net->workspace == NULL || !alloc_optimizer_state(net, optimizer)) {
+        return -6; // Error: out of memory
+    }
+    return 0;
 }
 
-// Exported training function (backward compatible)
-EMSCRIPTEN_KEEPALIVE
-float train_ann(float* inputs, float* outputs, int n_rows, int n_inputs) {
-    // Initialize network with fixed hidden layer size and sigmoid activation
-    int n_hidden = 6;
-    int n_outputs = 1;
-    int activation_type = 0; // Sigmoid for backward compatibility
-    init_network(n_inputs, n_hidden, n_outputs, activation_type);
+// Record one epoch's mean loss in loss_history (if provided) and decide early
+// stopping: below 0.001 the remaining epochs are filled with the final loss
+// and 1 is returned.
+static int record_epoch_loss(float* loss_history, int epoch, int epochs, float loss) {
+    if (loss_history != NULL) {
+        loss_history[epoch] = loss;
+    }
+    if (loss >= 0.001f) {
+        return 0;
+    }
+    if (loss_history != NULL) {
+        for (int e = epoch + 1; e < epochs; e++) {
+            loss_history[e] = loss;
+        }
+    }
+    return 1;
+}
+
+// Per-sample SGD training loop shared by train_ann and train_ann_v2
+// (learning rate 0.01, 300 epochs, early stop below 0.001)
+static float train_per_sample(NeuralNetwork* net, float* inputs, float* outputs, int n_rows, int n_inputs,
+                              int n_hidden, int activation_type, float* loss_history) {
+    // Initialize network with configurable parameters (or warm start)
+    NetworkShape shape = single_hidden_shape(n_inputs, n_hidden, activation_type);
+    if (begin_training(net, &shape, 0, 0, OPTIMIZER_SGD) < 0) {
+        return -6.0f; // Error: out of memory
+    }
     
     // Training hyperparameters
     float learning_rate = 0.01f;
@@ -214,29 +801,27 @@ float train_ann(float* inputs, float* outputs, int n_rows, int n_inputs) {
     // Training loop
     for (int epoch = 0; epoch < epochs; epoch++) {
         float total_loss = 0.0f;
-        
+    
         // Iterate through all training samples
         for (int row = 0; row < n_rows; row++) {
             // Get input for this row
             float* input_row = &inputs[row * n_inputs];
             float target = outputs[row];
-            
+    
             // Forward pass
-            compute_forward_pass(input_row);
-            
+            float* output = compute_forward_pass(net, input_row, &net->sample);
+    
             // Compute error and loss
-            float error = network.output_activation[0] - target;
+            float error = output[0] - target;
             total_loss += error * error;
-            
+    
             // Backward pass and weight update
-            compute_backward_pass(input_row, target, learning_rate);
+            compute_backward_pass(net, input_row, target, learning_rate, &net->sample);
         }
-        
-        // Compute average loss for this epoch
+    
+        // Compute average loss for this epoch, record it, stop early if very small
         final_loss = total_loss / n_rows;
-        
-        // Early stopping if loss is very small
-        if (final_loss < 0.001f) {
+        if (record_epoch_loss(loss_history, epoch, epochs, final_loss)) {
             break;
         }
     }
@@ -244,115 +829,1922 @@ float train_ann(float* inputs, float* outputs, int n_rows, int n_inputs) {
     return final_loss;
 }
 
+// Exported training function (backward compatible)
+EMSCRIPTEN_KEEPALIVE
+float train_ann(float* inputs, float* outputs, int n_rows, int n_inputs) {
+    // Fixed hidden layer size and sigmoid activation
+    return train_per_sample(&default_network, inputs, outputs, n_rows, n_inputs, 6, 0, NULL);
+}
+
 // Exported training function v2 with configurable architecture
 EMSCRIPTEN_KEEPALIVE
 float train_ann_v2(float* inputs, float* outputs, int n_rows, int n_inputs, 
                    int n_hidden, int activation_type, float* loss_history) {
     // Parameter validation
-    if (n_inputs < 1 || n_inputs > 10) {
-        return -1.0f; // Error: invalid input size
+    float config_error = validate_training_config(n_rows, n_inputs, n_hidden, activation_type);
+    if (config_error < 0.0f) {
+        return config_error;
+    }
+    
+    return train_per_sample(&default_network, inputs, outputs, n_rows, n_inputs, n_hidden, activation_type,
+                            loss_history);
+}
+
+// Reusable barrier for the data-parallel training threads (pthread_barrier_t
+// is not available on every platform)
+typedef struct {
+#ifdef ANN_ENABLE_THREADS
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+#endif
+    int n_threads;
+    int waiting;
+    int generation;
+} TrainBarrier;
+
+static void barrier_init(TrainBarrier* barrier, int n_threads) {
+#ifdef ANN_ENABLE_THREADS
+    pthread_mutex_init(&barrier->mutex, NULL);
+    pthread_cond_init(&barrier->cond, NULL);
+#endif
+    barrier->n_threads = n_threads;
+    barrier->waiting = 0;
+    barrier->generation = 0;
+}
+
+static void barrier_wait(TrainBarrier* barrier) {
+    if (barrier->n_threads <= 1) {
+        return;
     }
-    if (n_hidden < 2 || n_hidden > 20) {
-        return -2.0f; // Error: invalid hidden layer size
+#ifdef ANN_ENABLE_THREADS
+    pthread_mutex_lock(&barrier->mutex);
+    int generation = barrier->generation;
+    if (++barrier->waiting == barrier->n_threads) {
+        barrier->waiting = 0;
+        barrier->generation++;
+        pthread_cond_broadcast(&barrier->cond);
+    } else {
+        while (generation == barrier->generation) {
+            pthread_cond_wait(&barrier->cond, &barrier->mutex);
+        }
     }
-    if (activation_type < 0 || activation_type > 2) {
-        return -3.0f; // Error: invalid activation type
+    pthread_mutex_unlock(&barrier->mutex);
+#endif
+}
+
+static void barrier_destroy(TrainBarrier* barrier) {
+#ifdef ANN_ENABLE_THREADS
+    pthread_mutex_destroy(&barrier->mutex);
+    pthread_cond_destroy(&barrier->cond);
+#else
+    (void)barrier;
+#endif
+}
+
+// Shared state of one training run
+typedef struct {
+    NeuralNetwork* net;
+    float* inputs;
+    float* outputs;
+    int n_rows;
+    int n_inputs;
+    int batch_size;
+    int optimizer;
+    float learning_rate;
+    int epochs;
+    float* loss_history;
+    
+    int n_threads;
+    int steps_per_epoch;   // Batches in the largest shard
+    void* (*worker_fn)(void*);  // Loop run by every thread (train_worker or hogwild_worker)
+    TrainBarrier barrier;
+    int start_state;       // Start gate for spawned threads: 0 wait, 1 run, -1 abort
+    int stop;              // Set by thread 0 when training should end
+    float final_loss;
+    float thread_loss[MAX_TRAIN_THREADS];
+} TrainJob;
+
+// Per-thread shard of the training rows
+typedef struct {
+    TrainJob* job;
+    int index;
+    int shard_start;
+    int shard_rows;
+} TrainWorker;
+
+// End-of-epoch bookkeeping, run by thread 0 while the others wait at the
+// barrier: average the per-thread losses, record history, decide early stop
+static void finish_epoch(TrainJob* job, int epoch) {
+    // Compute average loss for this epoch
+    float epoch_loss = 0.0f;
+    for (int t = 0; t < job->n_threads; t++) {
+        epoch_loss += job->thread_loss[t];
     }
-    if (n_rows < 1) {
-        return -4.0f; // Error: invalid number of rows
+    job->final_loss = epoch_loss / job->n_rows;
+    
+    // Store loss history and stop early if loss is very small
+    if (record_epoch_loss(job->loss_history, epoch, job->epochs, job->final_loss)) {
+        job->stop = 1;
     }
+}
+
+// Data-parallel training loop run by every thread. Each step, every thread
+// computes summed gradients for its next mini-batch against the shared
+// weights; thread 0 then reduces them into its workspace and applies one
+// optimizer step while the others wait at the barrier.
+static void* train_worker(void* arg) {
+    TrainWorker* worker = (TrainWorker*)arg;
+    TrainJob* job = worker->job;
+    NeuralNetwork* net = job->net;
+    BatchWorkspace* ws = &net->batch[worker->index];
     
-    // Initialize network with configurable parameters
-    int n_outputs = 1;
-    init_network(n_inputs, n_hidden, n_outputs, activation_type);
+    for (int epoch = 0; epoch < job->epochs && !job->stop; epoch++) {
+        float total_loss = 0.0f;
     
-    // Training hyperparameters
-    float learning_rate = 0.01f;
-    int epochs = 300;
+        for (int s = 0; s < job->steps_per_epoch; s++) {
+            // Gradients for this thread's next mini-batch (zero once its shard is exhausted)
+            int row = s * job->batch_size;
+            int rows = worker->shard_rows - row;
+            if (rows > job->batch_size) {
+                rows = job->batch_size;
+            }
+            if (rows > 0) {
+                int start = worker->shard_start + row;
+                total_loss += compute_batch_gradients(net, ws, &job->inputs[start * job->n_inputs],
+                                                      &job->outputs[start], rows);
+            } else {
+                memset(ws->grads, 0, net->n_params * sizeof(float));
+            }
+            job->thread_loss[worker->index] = total_loss;
     
-    float final_loss = 0.0f;
+            barrier_wait(&job->barrier);
     
-    // Training loop
-    for (int epoch = 0; epoch < epochs; epoch++) {
+            if (worker->index == 0) {
+                // Reduce: grads_0 += grads_t (update_weights with lr = -1 is an exact add)
+                for (int t = 1; t < job->n_threads; t++) {
+                    update_weights(ws->grads, net->batch[t].grads, -1.0f, net->n_params);
+                }
+                apply_optimizer_step(net, ws, job->optimizer, job->learning_rate, ++net->opt_step);
+    
+                if (s == job->steps_per_epoch - 1) {
+                    finish_epoch(job, epoch);
+                }
+            }
+    
+            barrier_wait(&job->barrier);
+        }
+    }
+    return NULL;
+}
+
+// Hogwild training loop run by every thread: per-sample SGD over the thread's
+// shard (the same compute_forward_pass / compute_backward_pass as
+// train_ann_v2) against the shared weights, with no locks. Updates from
+// different threads race; on the small networks here collisions are rare and
+// a lost or torn update only perturbs SGD noise. Threads only synchronize at
+// epoch boundaries to combine losses.
+static void* hogwild_worker(void* arg) {
+    TrainWorker* worker = (TrainWorker*)arg;
+    TrainJob* job = worker->job;
+    NeuralNetwork* net = job->net;
+    BatchWorkspace* ws = &net->batch[worker->index];
+    SampleScratch scratch = {ws->activations, ws->deltas};
+    
+    for (int epoch = 0; epoch < job->epochs && !job->stop; epoch++) {
         float total_loss = 0.0f;
-        
-        // Iterate through all training samples
-        for (int row = 0; row < n_rows; row++) {
-            // Get input for this row
-            float* input_row = &inputs[row * n_inputs];
-            float target = outputs[row];
-            
-            // Forward pass
-            compute_forward_pass(input_row);
-            
-            // Compute error and loss
-            float error = network.output_activation[0] - target;
+    
+        for (int row = worker->shard_start; row < worker->shard_start + worker->shard_rows; row++) {
+            float* input_row = &job->inputs[row * job->n_inputs];
+            float target = job->outputs[row];
+    
+            float* output = compute_forward_pass(net, input_row, &scratch);
+            float error = output[0] - target;
             total_loss += error * error;
-            
-            // Backward pass and weight update
-            compute_backward_pass(input_row, target, learning_rate);
+            compute_backward_pass(net, input_row, target, job->learning_rate, &scratch);
         }
-        
-        // Compute average loss for this epoch
-        final_loss = total_loss / n_rows;
-        
-        // Store loss history if provided
-        if (loss_history != NULL) {
-            loss_history[epoch] = final_loss;
-        }
-        
-        // Early stopping if loss is very small
-        if (final_loss < 0.001f) {
-            // Fill remaining epochs with final loss
-            if (loss_history != NULL) {
-                for (int e = epoch + 1; e < epochs; e++) {
-                    loss_history[e] = final_loss;
-                }
-            }
-            break;
+        job->thread_loss[worker->index] = total_loss;
+    
+        barrier_wait(&job->barrier);
+        if (worker->index == 0) {
+            finish_epoch(job, epoch);
         }
+        barrier_wait(&job->barrier);
+    }
+    return NULL;
+}
+
+#ifdef ANN_ENABLE_THREADS
+// Open (1) or abort (-1) the start gate; uses the barrier's mutex and condition
+static void signal_start(TrainJob* job, int state) {
+    pthread_mutex_lock(&job->barrier.mutex);
+    job->start_state = state;
+    pthread_cond_broadcast(&job->barrier.cond);
+    pthread_mutex_unlock(&job->barrier.mutex);
+}
+
+// Entry point of spawned threads: wait until every thread has been created
+static void* train_thread_main(void* arg) {
+    TrainJob* job = ((TrainWorker*)arg)->job;
+    pthread_mutex_lock(&job->barrier.mutex);
+    while (job->start_state == 0) {
+        pthread_cond_wait(&job->barrier.cond, &job->barrier.mutex);
     }
+    int state = job->start_state;
+    pthread_mutex_unlock(&job->barrier.mutex);
     
-    return final_loss;
+    return (state > 0) ? job->worker_fn(arg) : NULL;
 }
+#endif
 
-// Exported prediction function
-EMSCRIPTEN_KEEPALIVE
-float run_ann(float* input, int n_inputs) {
-    // Validate that network is trained
-    if (!network.is_initialized) {
-        return -1.0f; // Error: network not trained
+// Clamp the thread count and split n_rows into contiguous shards (the first
+// n_rows % n_threads shards get one extra row). Returns the thread count used.
+static int setup_shards(TrainJob* job, TrainWorker* workers, int n_rows, int n_threads) {
+#ifndef ANN_ENABLE_THREADS
+    n_threads = 1;
+#endif
+    if (n_threads > MAX_TRAIN_THREADS) {
+        n_threads = MAX_TRAIN_THREADS;
+    }
+    if (n_threads > n_rows) {
+        n_threads = n_rows;
+    }
+    if (n_threads < 1) {
+        n_threads = 1;
     }
     
-    // Validate input dimensions
-    if (n_inputs != network.n_inputs) {
-        return -1.0f; // Error: dimension mismatch
+    int shard_base = n_rows / n_threads;
+    int shard_extra = n_rows % n_threads;
+    int start = 0;
+    for (int t = 0; t < n_threads; t++) {
+        workers[t].job = job;
+        workers[t].index = t;
+        workers[t].shard_start = start;
+        workers[t].shard_rows = shard_base + (t < shard_extra ? 1 : 0);
+        start += workers[t].shard_rows;
     }
+    job->n_threads = n_threads;
+    return n_threads;
+}
+
+// Run job->worker_fn on every shard: spawned threads wait at the start gate,
+// the calling thread runs shard 0. Returns 0 if the threads cannot be started.
+static int run_train_threads(TrainJob* job, TrainWorker* workers) {
+    int ok = 1;
+    barrier_init(&job->barrier, job->n_threads);
     
-    // Compute forward pass
-    compute_forward_pass(input);
+#ifdef ANN_ENABLE_THREADS
+    pthread_t threads[MAX_TRAIN_THREADS];
+    int started = 1;
+    for (; started < job->n_threads; started++) {
+        if (pthread_create(&threads[started], NULL, train_thread_main, &workers[started]) != 0) {
+            ok = 0;
+            break;
+        }
+    }
+    signal_start(job, ok ? 1 : -1);
+    if (ok) {
+        job->worker_fn(&workers[0]);
+    }
+    for (int t = 1; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+#else
+    job->worker_fn(&workers[0]);
+#endif
     
-    // Return output activation
-    return network.output_activation[0];
+    barrier_destroy(&job->barrier);
+    return ok;
 }
 
-// Exported weight extraction function
-EMSCRIPTEN_KEEPALIVE
-void get_weights(float* weights_ih_out, float* weights_ho_out) {
-    // Validate that network is initialized
-    if (!network.is_initialized) {
-        return;
+// Shared mini-batch training loop for train_ann_v3, train_ann_v4 and
+// train_ann_parallel. The rows are split into n_threads contiguous shards;
+// each step reduces one mini-batch per shard into a single update, so with
+// one thread this is plain mini-batch training. shape = NULL continues from
+// the network's current weights and optimizer state (train_network_epochs).
+// Arguments are validated by the callers; returns the final epoch loss, or
+// -6 when the workspace, optimizer state or threads cannot be allocated.
+static float train_minibatch(NeuralNetwork* net, float* inputs, float* outputs, int n_rows,
+                             const NetworkShape* shape, int batch_size,
+                             int optimizer, float learning_rate, int epochs,
+                             int n_threads, float* loss_history) {
+    TrainJob job;
+    TrainWorker workers[MAX_TRAIN_THREADS];
+    memset(&job, 0, sizeof(job));
+    n_threads = setup_shards(&job, workers, n_rows, n_threads);
+    
+    // Mini-batches never span shards
+    int max_shard = workers[0].shard_rows;
+    if (batch_size > max_shard) {
+        batch_size = max_shard;
     }
     
-    // Copy input-to-hidden weights
-    if (weights_ih_out != NULL) {
-        memcpy(weights_ih_out, network.weights_ih, 
-               network.n_inputs * network.n_hidden * sizeof(float));
+    // Initialize network with configurable parameters, or keep training it
+    int status = shape != NULL ? begin_training(net, shape, batch_size, n_threads, optimizer)
+                               : continue_training(net, batch_size, n_threads, optimizer);
+    if (status < 0) {
+        return -6.0f; // Error: out of memory
     }
     
-    // Copy hidden-to-output weights
-    if (weights_ho_out != NULL) {
-        memcpy(weights_ho_out, network.weights_ho, 
-               network.n_hidden * network.n_outputs * sizeof(float));
+    job.net = net;
+    job.inputs = inputs;
+    job.outputs = outputs;
+    job.n_rows = n_rows;
+    job.n_inputs = net->n_inputs;
+    job.batch_size = batch_size;
+    job.optimizer = optimizer;
+    job.learning_rate = learning_rate;
+    job.epochs = epochs;
+    job.loss_history = loss_history;
+    job.steps_per_epoch = (max_shard + batch_size - 1) / batch_size;
+    job.worker_fn = train_worker;
+    
+    if (!run_train_threads(&job, workers)) {
+        return -6.0f; // Error: could not start threads
+    }
+    return job.final_loss;
+}
+#endif // ANN_INFERENCE_ONLY
+
+// ============================================================================
+// Handle-based API: independent models, each with its own weights, optimizer
+// state, scratch buffers and RNG. Handles are opaque pointers (plain numbers
+// in JavaScript). Calls on different handles may run concurrently. Every call
+// taking a handle accepts NULL for the default network of train_ann*, run_ann
+// and get_weights (destroy_network ignores it).
+// ============================================================================
+
+// Create an empty, untrained network. Returns NULL when out of memory.
+EMSCRIPTEN_KEEPALIVE
+NeuralNetwork* create_network() {
+    NeuralNetwork* net = (NeuralNetwork*)ann_malloc(sizeof(NeuralNetwork));
+    if (net == NULL) {
+        return NULL;
+    }
+    memset(net, 0, sizeof(NeuralNetwork));
+    net->seed = 12345;
+    return net;
+}
+
+// Free a network and everything it owns (NULL is ignored)
+EMSCRIPTEN_KEEPALIVE
+void destroy_network(NeuralNetwork* net) {
+    if (net == NULL) {
+        return;
     }
+    free_network_buffers(net);
+    free(net);
+}
+
+#ifndef ANN_INFERENCE_ONLY
+// Warm start for full retrains: while enabled, every train_* call on the
+// model whose architecture (inputs, layer sizes and activations) matches the
+// trained model starts from the current weights instead of a new Xavier
+// initialization; the optimizer state starts from zero and the input
+// normalization is kept. Other architectures still initialize from scratch.
+// model is a handle, or NULL for the default network. Returns 0.
+EMSCRIPTEN_KEEPALIVE
+int set_network_warm_start(NeuralNetwork* model, int enabled) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    net->warm_start = enabled != 0;
+    return 0;
+}
+
+// Train a network handle: mini-batch training with a selectable optimizer,
+// data-parallel over n_threads (same arguments and error codes as
+// train_ann_parallel). Retraining replaces the model
+// (see set_network_warm_start to keep its weights).
+EMSCRIPTEN_KEEPALIVE
+float train_network(NeuralNetwork* model, float* inputs, float* outputs, int n_rows, int n_inputs,
+                    int n_hidden, int activation_type, int batch_size,
+                    int optimizer, float learning_rate, int epochs,
+                    int n_threads, float* loss_history) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Parameter validation
+    float config_error = validate_training_config(n_rows, n_inputs, n_hidden, activation_type);
+    if (config_error < 0.0f) {
+        return config_error;
+    }
+    if (batch_size < 1) {
+        return -5.0f; // Error: invalid batch size
+    }
+    if (optimizer < OPTIMIZER_SGD || optimizer > OPTIMIZER_ADAM) {
+        return -7.0f; // Error: invalid optimizer
+    }
+    if (!(learning_rate > 0.0f) || epochs < 1) {
+        return -8.0f; // Error: invalid learning rate or epoch count
+    }
+    if (n_threads < 1) {
+        return -9.0f; // Error: invalid thread count
+    }
+    
+    NetworkShape shape = single_hidden_shape(n_inputs, n_hidden, activation_type);
+    return train_minibatch(net, inputs, outputs, n_rows, &shape, batch_size,
+                           optimizer, learning_rate, epochs, n_threads, loss_history);
+}
+
+// Architecture of a layer-stack model: n_hidden_layers hidden layers from the
+// caller's arrays, then the given output layer.
+// Returns 0, or -15 for an invalid layer count or NULL layer arrays.
+static int layer_stack_shape(NetworkShape* shape, int n_inputs, int n_hidden_layers,
+                             const int* hidden_sizes, const int* hidden_activations,
+                             int n_outputs, int output_activation) {
+    if (n_hidden_layers < 1 || n_hidden_layers > MAX_LAYERS - 1 ||
+        hidden_sizes == NULL || hidden_activations == NULL) {
+        return -15; // Error: invalid layer configuration
+    }
+    
+    memset(shape, 0, sizeof(NetworkShape));
+    shape->n_inputs = n_inputs;
+    shape->n_layers = n_hidden_layers + 1;
+    memcpy(shape->sizes, hidden_sizes, n_hidden_layers * sizeof(int));
+    memcpy(shape->activations, hidden_activations, n_hidden_layers * sizeof(int));
+    shape->sizes[n_hidden_layers] = n_outputs;
+    shape->activations[n_hidden_layers] = output_activation;
+    return 0;
+}
+
+// Validate a layer stack and the mini-batch settings.
+// Returns 0 or the error code.
+static float validate_layer_stack(const NetworkShape* shape, int n_rows, int batch_size, int optimizer,
+                                  float learning_rate, int epochs, int n_threads) {
+    int shape_error = validate_network_shape(shape);
+    if (shape_error < 0) {
+        return (float)shape_error;
+    }
+    if (n_rows < 1) {
+        return -4.0f; // Error: invalid number of rows
+    }
+    if (batch_size < 1) {
+        return -5.0f; // Error: invalid batch size
+    }
+    if (optimizer < OPTIMIZER_SGD || optimizer > OPTIMIZER_ADAM) {
+        return -7.0f; // Error: invalid optimizer
+    }
+    if (!(learning_rate > 0.0f) || epochs < 1) {
+        return -8.0f; // Error: invalid learning rate or epoch count
+    }
+    if (n_threads < 1) {
+        return -9.0f; // Error: invalid thread count
+    }
+    return 0.0f;
+}
+
+// Validate a layer stack and the mini-batch settings, then train it
+// (shared by train_network_layers and train_network_classifier)
+static float train_layer_stack(NeuralNetwork* net, float* inputs, float* outputs, int n_rows,
+                               const NetworkShape* shape, int batch_size, int optimizer,
+                               float learning_rate, int epochs, int n_threads, float* loss_history) {
+    // Parameter validation
+    float error = validate_layer_stack(shape, n_rows, batch_size, optimizer, learning_rate, epochs, n_threads);
+    if (error < 0.0f) {
+        return error;
+    }
+    
+    return train_minibatch(net, inputs, outputs, n_rows, shape, batch_size,
+                           optimizer, learning_rate, epochs, n_threads, loss_history);
+}
+
+// Train a network handle with any stack of dense layers: n_hidden_layers
+// hidden layers (1 to MAX_LAYERS - 1), layer l with hidden_sizes[l] units
+// (2-1024) and activation hidden_activations[l] (0=sigmoid, 1=relu, 2=tanh),
+// then one sigmoid output unit. n_inputs may be 1-1024. Training is as
+// train_network (same remaining arguments and error codes), so one hidden
+// layer reproduces train_network. Additional error code: -15 invalid layer
+// count or NULL layer arrays.
+EMSCRIPTEN_KEEPALIVE
+float train_network_layers(NeuralNetwork* model, float* inputs, float* outputs, int n_rows, int n_inputs,
+                           int n_hidden_layers, const int* hidden_sizes, const int* hidden_activations,
+                           int batch_size, int optimizer, float learning_rate, int epochs,
+                           int n_threads, float* loss_history) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Hidden layers, then the sigmoid output unit
+    NetworkShape shape;
+    if (layer_stack_shape(&shape, n_inputs, n_hidden_layers, hidden_sizes, hidden_activations, 1, 0) < 0) {
+        return -15.0f; // Error: invalid layer configuration
+    }
+    return train_layer_stack(net, inputs, outputs, n_rows, &shape, batch_size, optimizer,
+                             learning_rate, epochs, n_threads, loss_history);
+}
+
+// Every label must index a class (the backward kernel reads probs[label])
+static int valid_class_labels(const float* labels, int n_rows, int n_classes) {
+    for (int r = 0; r < n_rows; r++) {
+        if (!(labels[r] >= 0.0f && labels[r] < (float)n_classes) || labels[r] != floorf(labels[r])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Train a network handle as an n_classes-way classifier: the hidden layers of
+// train_network_layers, then a softmax output layer trained with
+// cross-entropy (the fused softmax / cross-entropy gradient). labels[n_rows]
+// holds each row's class index 0..n_classes-1 as a float. The loss (and
+// loss_history) is the mean cross-entropy. Predictions: run_ann_batch gives
+// n_classes probabilities per row, classify_batch the most likely class, and
+// run_network / run_ann the class index of one row.
+// Error codes as train_network_layers, plus -15 for n_classes outside 2-1024
+// and -16 for a label that is not a class index.
+EMSCRIPTEN_KEEPALIVE
+float train_network_classifier(NeuralNetwork* model, float* inputs, float* labels, int n_rows, int n_inputs,
+                               int n_classes, int n_hidden_layers, const int* hidden_sizes,
+                               const int* hidden_activations, int batch_size, int optimizer,
+                               float learning_rate, int epochs, int n_threads, float* loss_history) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Hidden layers, then the softmax output layer
+    NetworkShape shape;
+    if (layer_stack_shape(&shape, n_inputs, n_hidden_layers, hidden_sizes, hidden_activations,
+                          n_classes, ACTIVATION_SOFTMAX) < 0) {
+        return -15.0f; // Error: invalid layer configuration
+    }
+    
+    if (n_classes < 2 || n_classes > MAX_OUTPUT_CLASSES) {
+        return -15.0f; // Error: invalid layer configuration
+    }
+    
+    if (!valid_class_labels(labels, n_rows, n_classes)) {
+        return -16.0f; // Error: invalid class label
+    }
+    return train_layer_stack(net, inputs, labels, n_rows, &shape, batch_size, optimizer,
+                             learning_rate, epochs, n_threads, loss_history);
+}
+
+// Shared validation for continued training of a trained handle: the model
+// must be trained, take n_inputs inputs and (for classifiers) the labels must
+// be class indices. Returns 0 or the error code.
+static float validate_continued_training(const NeuralNetwork* net, float* outputs, int n_rows, int n_inputs,
+                                         int optimizer, float learning_rate) {
+    if (!net->is_initialized || net->workspace == NULL) {
+        return -17.0f; // Error: no trained model to continue
+    }
+    if (n_inputs != net->n_inputs) {
+        return -1.0f; // Error: input size does not match the model
+    }
+    if (n_rows < 1) {
+        return -4.0f; // Error: invalid number of rows
+    }
+    if (optimizer < OPTIMIZER_SGD || optimizer > OPTIMIZER_ADAM) {
+        return -7.0f; // Error: invalid optimizer
+    }
+    if (!(learning_rate > 0.0f)) {
+        return -8.0f; // Error: invalid learning rate
+    }
+    if (net->n_outputs > 1 && !valid_class_labels(outputs, n_rows, net->n_outputs)) {
+        return -16.0f; // Error: invalid class label
+    }
+    return 0.0f;
+}
+
+// Continue training a trained handle on (new) rows for `epochs` epochs of
+// mini-batch training, starting from its current weights instead of a fresh
+// initialization. Arguments as train_network without the architecture, which
+// is the model's; inputs must be normalized like the original training data
+// (the model's input normalization is kept). The optimizer moments and Adam
+// step count carry over when the optimizer is unchanged, so consecutive
+// calls continue one optimization run. Models loaded with load_model_view or
+// map_model_file get their own copy of the parameters first.
+// Returns the final epoch loss. Error codes as train_network, plus -1 if
+// n_inputs does not match the model, -16 invalid class label (classifiers)
+// and -17 if the handle holds no trained model.
+EMSCRIPTEN_KEEPALIVE
+float train_network_epochs(NeuralNetwork* model, float* inputs, float* outputs, int n_rows, int n_inputs,
+                           int batch_size, int optimizer, float learning_rate, int epochs,
+                           int n_threads, float* loss_history) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    float error = validate_continued_training(net, outputs, n_rows, n_inputs, optimizer, learning_rate);
+    if (error < 0.0f) {
+        return error;
+    }
+    if (batch_size < 1) {
+        return -5.0f; // Error: invalid batch size
+    }
+    if (epochs < 1) {
+        return -8.0f; // Error: invalid epoch count
+    }
+    if (n_threads < 1) {
+        return -9.0f; // Error: invalid thread count
+    }
+    
+    return train_minibatch(net, inputs, outputs, n_rows, NULL, batch_size,
+                           optimizer, learning_rate, epochs, n_threads, loss_history);
+}
+
+// Online learning: one optimizer update of a trained handle from the
+// gradients summed over n_rows rows (one mini-batch), continuing from its
+// current weights and optimizer state as train_network_epochs. Meant to be
+// called as each batch of new rows arrives; the scratch buffers only grow
+// when a larger batch than before arrives.
+// Returns the mean loss of the rows before the update. Error codes as
+// train_network_epochs.
+EMSCRIPTEN_KEEPALIVE
+float train_network_step(NeuralNetwork* model, float* inputs, float* outputs, int n_rows, int n_inputs,
+                         int optimizer, float learning_rate) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    float error = validate_continued_training(net, outputs, n_rows, n_inputs, optimizer, learning_rate);
+    if (error < 0.0f) {
+        return error;
+    }
+    if (continue_training(net, n_rows, 1, optimizer) < 0) {
+        return -6.0f; // Error: out of memory
+    }
+    
+    BatchWorkspace* ws = &net->batch[0];
+    float loss = compute_batch_gradients(net, ws, inputs, outputs, n_rows);
+    apply_optimizer_step(net, ws, optimizer, learning_rate, ++net->opt_step);
+    return loss / n_rows;
+}
+
+// Monotonic clock in milliseconds (time budget of train_network_run_for_ms)
+static double clock_ms(void) {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#elif defined(_WIN32)
+    return clock() * 1000.0 / CLOCKS_PER_SEC;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1.0e6;
+#endif
+}
+
+// Run the next mini-batch of a resumable run: the single-thread step of
+// train_minibatch, so a run split into slices matches one train_network_layers
+// call with n_threads = 1. Returns 1 once the run has completed.
+static int train_session_step(NeuralNetwork* net) {
+    TrainSession* session = &net->session;
+    BatchWorkspace* ws = &net->batch[0];
+    int rows = session->n_rows - session->row;
+    if (rows > session->batch_size) {
+        rows = session->batch_size;
+    }
+    
+    session->epoch_loss += compute_batch_gradients(net, ws, &session->inputs[session->row * net->n_inputs],
+                                                   &session->outputs[session->row], rows);
+    apply_optimizer_step(net, ws, session->optimizer, session->learning_rate, ++net->opt_step);
+    session->row += rows;
+    if (session->row < session->n_rows) {
+        return 0;
+    }
+    
+    // End of epoch: record the loss, stop early if very small
+    session->final_loss = session->epoch_loss / session->n_rows;
+    if (record_epoch_loss(session->loss_history, session->epoch, session->epochs, session->final_loss)) {
+        session->epoch = session->epochs;
+    } else {
+        session->epoch++;
+    }
+    session->row = 0;
+    session->epoch_loss = 0.0f;
+    return session->epoch >= session->epochs;
+}
+
+// Begin a resumable training run, so a caller that must stay responsive (the
+// browser main thread) can train in slices between other work. The model is
+// set up as by train_network_layers (n_classes = 1, one sigmoid output) or
+// train_network_classifier (n_classes = 2-1024, softmax output), with the
+// same arguments apart from n_threads (runs are single-threaded). No epoch
+// runs yet: drive the run with train_network_run_epochs or
+// train_network_run_for_ms and end it with train_network_finish. The state
+// lives in the model; inputs, outputs and loss_history must stay alive until
+// the run is finished, and loss_history[e] is written as epoch e completes.
+// Any other training call on the model, reloading or destroying it ends the
+// run. model is a handle, or NULL for the default network.
+// Returns 0, or the error codes of train_network_layers and
+// train_network_classifier (-15 also for n_classes outside 1-1024).
+EMSCRIPTEN_KEEPALIVE
+int train_network_begin(NeuralNetwork* model, float* inputs, float* outputs, int n_rows, int n_inputs,
+                        int n_hidden_layers, const int* hidden_sizes, const int* hidden_activations,
+                        int n_classes, int batch_size, int optimizer, float learning_rate, int epochs,
+                        float* loss_history) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Hidden layers, then a sigmoid output unit or a softmax output layer
+    NetworkShape shape;
+    if (n_classes < 1 || n_classes > MAX_OUTPUT_CLASSES ||
+        layer_stack_shape(&shape, n_inputs, n_hidden_layers, hidden_sizes, hidden_activations, n_classes,
+                          n_classes > 1 ? ACTIVATION_SOFTMAX : 0) < 0) {
+        return -15; // Error: invalid layer configuration
+    }
+    float error = validate_layer_stack(&shape, n_rows, batch_size, optimizer, learning_rate, epochs, 1);
+    if (error < 0.0f) {
+        return (int)error;
+    }
+    if (n_classes > 1 && !valid_class_labels(outputs, n_rows, n_classes)) {
+        return -16; // Error: invalid class label
+    }
+    
+    // Mini-batches never exceed the data
+    if (batch_size > n_rows) {
+        batch_size = n_rows;
+    }
+    if (begin_training(net, &shape, batch_size, 1, optimizer) < 0) {
+        return -6; // Error: out of memory
+    }
+    
+    TrainSession* session = &net->session;
+    memset(session, 0, sizeof(TrainSession));
+    session->inputs = inputs;
+    session->outputs = outputs;
+    session->n_rows = n_rows;
+    session->batch_size = batch_size;
+    session->optimizer = optimizer;
+    session->learning_rate = learning_rate;
+    session->epochs = epochs;
+    session->loss_history = loss_history;
+    session->active = 1;
+    return 0;
+}
+
+// Continue the model's resumable run until n_epochs more epochs have
+// completed (the first finishes an epoch left partway by
+// train_network_run_for_ms) or the run is complete.
+// Returns the number of epochs completed so far, which equals the requested
+// epoch count once the run is complete (early stopping counts as complete).
+// Error codes: -8 n_epochs < 1, -18 no run in progress.
+EMSCRIPTEN_KEEPALIVE
+int train_network_run_epochs(NeuralNetwork* model, int n_epochs) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    TrainSession* session = &net->session;
+    if (!session->active) {
+        return -18; // Error: no training run in progress
+    }
+    if (n_epochs < 1) {
+        return -8; // Error: invalid epoch count
+    }
+    
+    int target = session->epoch + n_epochs;
+    while (session->epoch < target && session->epoch < session->epochs) {
+        if (train_session_step(net)) {
+            break;
+        }
+    }
+    return session->epoch;
+}
+
+// Continue the model's resumable run for about budget_ms milliseconds: whole
+// mini-batches run until the budget is spent (at least one), so a slice may
+// end partway through an epoch. Pick the budget to fit a frame, e.g. 8-12 ms
+// on the browser main thread.
+// Returns the number of epochs completed so far, which equals the requested
+// epoch count once the run is complete.
+// Error codes: -8 budget_ms not positive, -18 no run in progress.
+EMSCRIPTEN_KEEPALIVE
+int train_network_run_for_ms(NeuralNetwork* model, float budget_ms) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    TrainSession* session = &net->session;
+    if (!session->active) {
+        return -18; // Error: no training run in progress
+    }
+    if (!(budget_ms > 0.0f)) {
+        return -8; // Error: invalid time budget
+    }
+    
+    double deadline = clock_ms() + budget_ms;
+    while (session->epoch < session->epochs) {
+        if (train_session_step(net) || clock_ms() >= deadline) {
+            break;
+        }
+    }
+    return session->epoch;
+}
+
+// End the model's resumable run, complete or not. Cancelling keeps the
+// weights reached so far, so the model can be used (or trained further with
+// train_network_epochs) either way.
+// Returns the mean loss of the last completed epoch (the mean over the
+// mini-batches run so far if no epoch completed), or -18 if no run is in
+// progress.
+EMSCRIPTEN_KEEPALIVE
+float train_network_finish(NeuralNetwork* model) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    TrainSession* session = &net->session;
+    if (!session->active) {
+        return -18.0f; // Error: no training run in progress
+    }
+    
+    float loss = session->final_loss;
+    if (session->epoch == 0 && session->row > 0) {
+        loss = session->epoch_loss / session->row;
+    }
+    memset(session, 0, sizeof(TrainSession));
+    return loss;
+}
+
+// Train a network handle with Hogwild asynchronous SGD (same arguments and
+// error codes as train_ann_hogwild)
+EMSCRIPTEN_KEEPALIVE
+float train_network_hogwild(NeuralNetwork* model, float* inputs, float* outputs, int n_rows, int n_inputs,
+                            int n_hidden, int activation_type, float learning_rate, int epochs,
+                            int n_threads, float* loss_history) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Parameter validation
+    float config_error = validate_training_config(n_rows, n_inputs, n_hidden, activation_type);
+    if (config_error < 0.0f) {
+        return config_error;
+    }
+    if (!(learning_rate > 0.0f) || epochs < 1) {
+        return -8.0f; // Error: invalid learning rate or epoch count
+    }
+    if (n_threads < 1) {
+        return -9.0f; // Error: invalid thread count
+    }
+    
+    TrainJob job;
+    TrainWorker workers[MAX_TRAIN_THREADS];
+    memset(&job, 0, sizeof(job));
+    n_threads = setup_shards(&job, workers, n_rows, n_threads);
+    
+    // One single-row BatchWorkspace per thread serves as its SampleScratch
+    NetworkShape shape = single_hidden_shape(n_inputs, n_hidden, activation_type);
+    if (begin_training(net, &shape, 1, n_threads, OPTIMIZER_SGD) < 0) {
+        return -6.0f; // Error: out of memory
+    }
+    
+    job.net = net;
+    job.inputs = inputs;
+    job.outputs = outputs;
+    job.n_rows = n_rows;
+    job.n_inputs = n_inputs;
+    job.learning_rate = learning_rate;
+    job.epochs = epochs;
+    job.loss_history = loss_history;
+    job.worker_fn = hogwild_worker;
+    
+    if (!run_train_threads(&job, workers)) {
+        return -6.0f; // Error: could not start threads
+    }
+    return job.final_loss;
+}
+#endif // ANN_INFERENCE_ONLY
+
+// Load a single-hidden-layer model from a flat parameter block in the
+// internal layout [weights_ih (input-major [n_inputs][n_hidden]), bias_h,
+// weights_ho, bias_o], i.e. n_inputs * n_hidden + 2 * n_hidden + 1 floats as
+// written by get_network_params. Deeper models travel through save_model.
+// Replaces any model already held by the handle.
+// Returns 0 on success, -1/-2/-3 for invalid dimensions or activation (as
+// train_ann_v2), -6 out of memory, -11 if params is NULL (as the model
+// loaders for missing data; the handle is left unchanged).
+EMSCRIPTEN_KEEPALIVE
+int load_network_params(NeuralNetwork* model, int n_inputs, int n_hidden, int activation_type,
+                        const float* params) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Parameter validation
+    float config_error = validate_training_config(1, n_inputs, n_hidden, activation_type);
+    if (config_error < 0.0f) {
+        return (int)config_error;
+    }
+    if (params == NULL) {
+        return -11; // Error: no parameter block
+    }
+    
+    NetworkShape shape = single_hidden_shape(n_inputs, n_hidden, activation_type);
+    init_network(net, &shape, 0, 0, NULL);
+    if (net->workspace == NULL) {
+        return -6; // Error: out of memory
+    }
+    
+    memcpy(net->params, params, net->n_params * sizeof(float));
+    return 0;
+}
+
+// Copy a model's flat parameter block into params_out: [weights, bias] for
+// each layer in order, weights input-major (as load_network_params for one
+// hidden layer). Call with params_out = NULL for the parameter count.
+// model is a handle from create_network, or NULL for the default network.
+// Returns the parameter count, or -1 if the network is not trained.
+EMSCRIPTEN_KEEPALIVE
+int get_network_params(const NeuralNetwork* model, float* params_out) {
+    const NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized) {
+        return -1; // Error: network not trained
+    }
+    
+    if (params_out != NULL) {
+        memcpy(params_out, net->params, net->n_params * sizeof(float));
+    }
+    return net->n_params;
+}
+
+// Copy a model's architecture: sizes_out[l] and activations_out[l] for every
+// dense layer, output layer last (either may be NULL; MAX_LAYERS = 8 entries
+// always suffice). model is a handle, or NULL for the default network.
+// Returns the layer count, or -1 if the network is not trained.
+EMSCRIPTEN_KEEPALIVE
+int get_network_layers(const NeuralNetwork* model, int* sizes_out, int* activations_out) {
+    const NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized) {
+        return -1; // Error: network not trained
+    }
+    
+    for (int l = 0; l < net->n_layers; l++) {
+        if (sizes_out != NULL) {
+            sizes_out[l] = net->layers[l].n_out;
+        }
+        if (activations_out != NULL) {
+            activations_out[l] = net->layers[l].activation;
+        }
+    }
+    return net->n_layers;
+}
+
+// ============================================================================
+// Feature statistics and input normalization
+// Typical use: normalize_columns on the training inputs, train, then
+// set_network_normalization so predictions on raw inputs get the same
+// transform.
+// ============================================================================
+
+#ifndef ANN_INFERENCE_ONLY
+// Transform for method from column statistics: x' = (x - offset) * scale.
+// Constant columns get scale 1 (they map to 0).
+static void normalization_transform(int method, const float* mean, const float* variance,
+                                    const float* min, const float* max, int n_cols,
+                                    float* offset, float* scale) {
+    for (int c = 0; c < n_cols; c++) {
+        float spread = method == NORMALIZE_ZSCORE ? sqrtf(variance[c]) : max[c] - min[c];
+        offset[c] = method == NORMALIZE_ZSCORE ? mean[c] : min[c];
+        scale[c] = spread > 0.0f ? 1.0f / spread : 1.0f;
+    }
+}
+
+// Per-column statistics of a row-major [n_rows][n_cols] matrix in one SIMD
+// pass: mean, population variance, min and max (each [n_cols]).
+// Returns 0, -1 if n_cols < 1, -4 if n_rows < 1.
+EMSCRIPTEN_KEEPALIVE
+int compute_column_stats(float* data, int n_rows, int n_cols,
+                         float* mean, float* variance, float* min, float* max) {
+    if (n_cols < 1) {
+        return -1; // Error: invalid column count
+    }
+    if (n_rows < 1) {
+        return -4; // Error: invalid number of rows
+    }
+    
+    column_stats_simd(data, n_rows, n_cols, mean, variance, min, max);
+    return 0;
+}
+
+// Normalize the columns of a row-major [n_rows][n_cols] matrix in place: one
+// statistics pass, then one transform pass. method: 1 = z-score, 2 = min-max
+// (to [0, 1]). offset_out and scale_out [n_cols] receive the transform, ready
+// for set_network_normalization.
+// Returns 0, -1 if n_cols is not 1-1024, -4 if n_rows < 1, -14 for an invalid
+// method.
+EMSCRIPTEN_KEEPALIVE
+int normalize_columns(float* data, int n_rows, int n_cols, int method,
+                      float* offset_out, float* scale_out) {
+    if (n_cols < 1 || n_cols > MAX_INPUT_FEATURES) {
+        return -1; // Error: invalid column count
+    }
+    if (n_rows < 1) {
+        return -4; // Error: invalid number of rows
+    }
+    if (method != NORMALIZE_ZSCORE && method != NORMALIZE_MINMAX) {
+        return -14; // Error: invalid normalization
+    }
+    
+    float mean[MAX_INPUT_FEATURES], variance[MAX_INPUT_FEATURES];
+    float min[MAX_INPUT_FEATURES], max[MAX_INPUT_FEATURES];
+    column_stats_simd(data, n_rows, n_cols, mean, variance, min, max);
+    normalization_transform(method, mean, variance, min, max, n_cols, offset_out, scale_out);
+    affine_columns_simd(data, n_rows, n_cols, offset_out, scale_out);
+    return 0;
+}
+#endif // ANN_INFERENCE_ONLY
+
+// Attach an input transform (as produced by normalize_columns, n_inputs floats
+// each) to a trained model. run_network*, run_ann and run_ann_batch then apply
+// it to raw inputs, and save_model / export_network_c carry it along.
+// Training clears it, so attach it after training. method 0 clears it
+// (offset and scale may then be NULL). model is a handle from create_network,
+// or NULL for the default network.
+// Returns 0, -1 if the network is not trained, -14 for an invalid method or a
+// non-finite transform.
+EMSCRIPTEN_KEEPALIVE
+int set_network_normalization(NeuralNetwork* model, int method, const float* offset, const float* scale) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized) {
+        return -1; // Error: network not trained
+    }
+    if (method == NORMALIZE_NONE) {
+        net->normalization = NORMALIZE_NONE;
+        return 0;
+    }
+    if ((method != NORMALIZE_ZSCORE && method != NORMALIZE_MINMAX) || offset == NULL || scale == NULL) {
+        return -14; // Error: invalid normalization
+    }
+    for (int i = 0; i < net->n_inputs; i++) {
+        if (!isfinite(offset[i]) || !isfinite(scale[i])) {
+            return -14; // Error: invalid normalization
+        }
+    }
+    
+    memcpy(net->input_offset, offset, net->n_inputs * sizeof(float));
+    memcpy(net->input_scale, scale, net->n_inputs * sizeof(float));
+    net->normalization = method;
+    return 0;
+}
+
+// Copy a model's input transform into offset_out / scale_out (n_inputs floats
+// each; either may be NULL) and return its method (0 = none), or -1 if the
+// network is not trained. model is a handle, or NULL for the default network.
+EMSCRIPTEN_KEEPALIVE
+int get_network_normalization(const NeuralNetwork* model, float* offset_out, float* scale_out) {
+    const NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized) {
+        return -1; // Error: network not trained
+    }
+    if (net->normalization != NORMALIZE_NONE) {
+        if (offset_out != NULL) {
+            memcpy(offset_out, net->input_offset, net->n_inputs * sizeof(float));
+        }
+        if (scale_out != NULL) {
+            memcpy(scale_out, net->input_scale, net->n_inputs * sizeof(float));
+        }
+    }
+    return net->normalization;
+}
+
+// ============================================================================
+// Binary model format, version 3 (little-endian):
+//   offset 0            ModelFileHeader (48 bytes)
+//   offset 48           layer table: n_layers x ModelFileLayer
+//   offset header_size  float parameters [n_params], layout as get_network_params
+//   then, if normalization != 0, float input_offset [n_inputs] and
+//   float input_scale [n_inputs]
+// Version 1 files have the 32-byte header (up to n_params) and no
+// normalization, version 2 files the 48-byte header and no layer table; both
+// describe one hidden layer and still load. header_size is a multiple of 16,
+// so the parameters are 16-byte aligned whenever the data is (e.g. a mapped
+// file), and later versions can extend the header without moving readers off
+// the parameter block.
+// ============================================================================
+
+#define MODEL_MAGIC 0x4D574E46u  // "FNWM" read as a little-endian uint32
+#define MODEL_FORMAT_VERSION 3
+#define MODEL_HEADER_V1_SIZE 32
+
+typedef struct {
+    unsigned int magic;        // MODEL_MAGIC
+    unsigned int version;      // Format version (1..MODEL_FORMAT_VERSION)
+    unsigned int header_size;  // Byte offset of the parameter block
+    int n_inputs;
+    int n_hidden;              // Units in the first hidden layer
+    int n_outputs;             // Units in the output layer (class count for softmax)
+    int activation_type;       // First hidden layer: 0=sigmoid, 1=relu, 2=tanh
+    int n_params;              // Parameter count (redundant, checked on load)
+    int normalization;         // Version 2: NORMALIZE_* input transform
+    int n_layers;              // Version 3: dense layers in the layer table
+    int reserved[2];           // Version 2: zero
+} ModelFileHeader;
+
+// Version 3 layer table entry
+typedef struct {
+    int units;
+    int activation;            // 0=sigmoid, 1=relu, 2=tanh, 3=softmax
+} ModelFileLayer;
+
+// Header size for a layer table of n_layers entries (16-byte multiple)
+static size_t model_header_size(int n_layers) {
+    return (sizeof(ModelFileHeader) + n_layers * sizeof(ModelFileLayer) + 15) & ~(size_t)15;
+}
+
+// Validate serialized model data and copy out its header and architecture.
+// Returns 0, -1/-2/-3 for invalid dimensions or activation, -11 for malformed
+// or truncated data, -12 for an unsupported format version.
+static int parse_model_header(const unsigned char* data, size_t size, ModelFileHeader* header,
+                              NetworkShape* shape) {
+    if (data == NULL || size < MODEL_HEADER_V1_SIZE) {
+        return -11; // Error: malformed model data
+    }
+    memset(header, 0, sizeof(ModelFileHeader));
+    memcpy(header, data, MODEL_HEADER_V1_SIZE);
+    if (header->magic != MODEL_MAGIC) {
+        return -11; // Error: malformed model data
+    }
+    if (header->version < 1 || header->version > MODEL_FORMAT_VERSION) {
+        return -12; // Error: unsupported format version
+    }
+    size_t min_header_size = header->version == 1 ? MODEL_HEADER_V1_SIZE : sizeof(ModelFileHeader);
+    if (header->header_size < min_header_size || header->header_size % 16 != 0 || size < header->header_size) {
+        return -11; // Error: malformed model data
+    }
+    if (header->version >= 2) {
+        memcpy(header, data, sizeof(ModelFileHeader));
+        if (header->normalization < NORMALIZE_NONE || header->normalization > NORMALIZE_MINMAX) {
+            return -11; // Error: malformed model data
+        }
+    }
+    
+    // Architecture: the layer table, or the single hidden layer of older versions
+    *shape = single_hidden_shape(header->n_inputs, header->n_hidden, header->activation_type);
+    if (header->version >= 3) {
+        if (header->n_layers < 2 || header->n_layers > MAX_LAYERS ||
+            header->header_size < model_header_size(header->n_layers)) {
+            return -11; // Error: malformed model data
+        }
+        shape->n_layers = header->n_layers;
+        for (int l = 0; l < header->n_layers; l++) {
+            ModelFileLayer layer;
+            memcpy(&layer, data + sizeof(ModelFileHeader) + l * sizeof(ModelFileLayer), sizeof(layer));
+            shape->sizes[l] = layer.units;
+            shape->activations[l] = layer.activation;
+        }
+        if (shape->sizes[0] != header->n_hidden || shape->activations[0] != header->activation_type) {
+            return -11; // Error: malformed model data
+        }
+    }
+    int shape_error = validate_network_shape(shape);
+    if (shape_error < 0) {
+        return shape_error == -15 ? -11 : shape_error;
+    }
+    
+    int n_params = 0;
+    for (int l = 0; l < shape->n_layers; l++) {
+        int n_in = l == 0 ? shape->n_inputs : shape->sizes[l - 1];
+        n_params += n_in * shape->sizes[l] + shape->sizes[l];
+    }
+    if (header->n_outputs != shape->sizes[shape->n_layers - 1] || header->n_params != n_params) {
+        return -11; // Error: malformed model data
+    }
+    int n_transform = header->normalization != NORMALIZE_NONE ? 2 * header->n_inputs : 0;
+    if (size < header->header_size + (size_t)(n_params + n_transform) * sizeof(float)) {
+        return -11; // Error: truncated model data
+    }
+    return 0;
+}
+
+// Copy the input normalization stored after the parameter block into net
+static void read_model_normalization(NeuralNetwork* net, const ModelFileHeader* header,
+                                     const unsigned char* data) {
+    net->normalization = header->normalization;
+    if (header->normalization != NORMALIZE_NONE) {
+        const unsigned char* transform = data + header->header_size + header->n_params * sizeof(float);
+        memcpy(net->input_offset, transform, header->n_inputs * sizeof(float));
+        memcpy(net->input_scale, transform + header->n_inputs * sizeof(float), header->n_inputs * sizeof(float));
+    }
+}
+
+// Serialize a model (architecture, all weights and biases and the input
+// normalization) into buf.
+// model is a handle from create_network, or NULL for the default network.
+// Returns the serialized size in bytes; buf is written only if buf_size is at
+// least that large, so a call with buf_size = 0 sizes the buffer.
+// Returns -1 if the network is not trained.
+EMSCRIPTEN_KEEPALIVE
+int save_model(const NeuralNetwork* model, unsigned char* buf, int buf_size) {
+    const NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized) {
+        return -1; // Error: network not trained
+    }
+    
+    size_t header_size = model_header_size(net->n_layers);
+    ModelFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = MODEL_MAGIC;
+    header.version = MODEL_FORMAT_VERSION;
+    header.header_size = (unsigned int)header_size;
+    header.n_inputs = net->n_inputs;
+    header.n_hidden = net->layers[0].n_out;
+    header.n_outputs = net->n_outputs;
+    header.activation_type = net->layers[0].activation;
+    header.n_params = net->n_params;
+    header.normalization = net->normalization;
+    header.n_layers = net->n_layers;
+    
+    size_t params_size = net->n_params * sizeof(float);
+    size_t transform_size = net->normalization != NORMALIZE_NONE ? net->n_inputs * sizeof(float) : 0;
+    int size = (int)(header_size + params_size + 2 * transform_size);
+    if (buf != NULL && buf_size >= size) {
+        memset(buf, 0, header_size);
+        memcpy(buf, &header, sizeof(header));
+        for (int l = 0; l < net->n_layers; l++) {
+            ModelFileLayer layer = {net->layers[l].n_out, net->layers[l].activation};
+            memcpy(buf + sizeof(header) + l * sizeof(ModelFileLayer), &layer, sizeof(layer));
+        }
+        memcpy(buf + header_size, net->params, params_size);
+        memcpy(buf + header_size + params_size, net->input_offset, transform_size);
+        memcpy(buf + header_size + params_size + transform_size, net->input_scale, transform_size);
+    }
+    return size;
+}
+
+// Restore a model written by save_model into a handle, copying the
+// parameters. Replaces any model already held by the handle.
+// Returns 0 on success, parse_model_header errors, -6 out of memory.
+EMSCRIPTEN_KEEPALIVE
+int load_model(NeuralNetwork* model, const unsigned char* data, int size) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    ModelFileHeader header;
+    NetworkShape shape;
+    int status = parse_model_header(data, size > 0 ? (size_t)size : 0, &header, &shape);
+    if (status < 0) {
+        return status;
+    }
+    
+    // The parameter block may be unaligned in data, so stage it via memcpy
+    init_network(net, &shape, 0, 0, NULL);
+    if (net->workspace == NULL) {
+        return -6; // Error: out of memory
+    }
+    memcpy(net->params, data + header.header_size, header.n_params * sizeof(float));
+    read_model_normalization(net, &header, data);
+    return 0;
+}
+
+// Zero-copy variant of load_model: the handle uses the parameter block inside
+// data in place (the small input normalization block is copied). data must
+// stay valid and unchanged until the handle is destroyed, reloaded or
+// retrained, and its parameter block must be 4-byte aligned (true for any
+// buffer from malloc). Only the scratch workspace is allocated. Error codes
+// as load_model (-11 also for misaligned data).
+EMSCRIPTEN_KEEPALIVE
+int load_model_view(NeuralNetwork* model, const unsigned char* data, int size) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    ModelFileHeader header;
+    NetworkShape shape;
+    int status = parse_model_header(data, size > 0 ? (size_t)size : 0, &header, &shape);
+    if (status < 0) {
+        return status;
+    }
+    
+    const unsigned char* params = data + header.header_size;
+    if ((uintptr_t)params % sizeof(float) != 0) {
+        return -11; // Error: misaligned parameter block
+    }
+    
+    init_network(net, &shape, 0, 0, (float*)params);
+    if (net->workspace == NULL) {
+        return -6; // Error: out of memory
+    }
+    read_model_normalization(net, &header, data);
+    return 0;
+}
+
+#ifdef ANN_HAVE_MMAP
+// Native loader: map a model file read-only and return a new network whose
+// parameters are a zero-copy view of the mapping (pages are faulted in on
+// first use). destroy_network unmaps the file. Returns NULL if the file cannot
+// be opened or mapped, or is not a valid model.
+EMSCRIPTEN_KEEPALIVE
+NeuralNetwork* map_model_file(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ModelFileHeader)) {
+        close(fd);
+        return NULL;
+    }
+    
+    size_t size = (size_t)st.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+    
+    NeuralNetwork* net = create_network();
+    if (net == NULL || load_model_view(net, (const unsigned char*)mapping, size > INT_MAX ? INT_MAX : (int)size) != 0) {
+        destroy_network(net);
+        munmap(mapping, size);
+        return NULL;
+    }
+    
+    // The network now owns the mapping
+    net->mapping = mapping;
+    net->mapping_size = size;
+    return net;
+}
+
+// Native helper: write a model in the save_model format to a file.
+// Returns 0 on success, -1 if the network is not trained, -13 on I/O failure.
+EMSCRIPTEN_KEEPALIVE
+int save_model_file(const NeuralNetwork* model, const char* path) {
+    int size = save_model(model, NULL, 0);
+    if (size < 0) {
+        return size;
+    }
+    
+    unsigned char* buf = (unsigned char*)ann_malloc(size);
+    if (buf == NULL) {
+        return -13; // Error: I/O failure
+    }
+    save_model(model, buf, size);
+    
+    FILE* file = fopen(path, "wb");
+    int ok = file != NULL && fwrite(buf, 1, size, file) == (size_t)size;
+    if (file != NULL && fclose(file) != 0) {
+        ok = 0;
+    }
+    free(buf);
+    return ok ? 0 : -13;
+}
+#endif // ANN_HAVE_MMAP
+
+// Allocate an inference context (NULL when out of memory). One context per
+// thread; a context can be used with any model.
+EMSCRIPTEN_KEEPALIVE
+InferenceContext* create_inference_context() {
+    return (InferenceContext*)ann_malloc(sizeof(InferenceContext));
+}
+
+// Free an inference context (NULL is ignored)
+EMSCRIPTEN_KEEPALIVE
+void destroy_inference_context(InferenceContext* ctx) {
+    free(ctx);
+}
+
+// Reentrant prediction: the model is read-only and all scratch state lives in
+// ctx, so any number of threads may score against one model without locks as
+// long as each uses its own context. model is a handle from create_network,
+// or NULL for the default network. The model must not be retrained while
+// predictions against it are in flight; train a separate handle instead.
+// Returns the output activation, or for a classifier the index of the most
+// likely class (use run_ann_batch for the probabilities).
+// Returns -1 if the network is not trained, the input size does not match or
+// ctx is NULL.
+EMSCRIPTEN_KEEPALIVE
+float run_network_ctx(const NeuralNetwork* model, InferenceContext* ctx, float* input, int n_inputs) {
+    const NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (ctx == NULL || !net->is_initialized || net->workspace == NULL) {
+        return -1.0f; // Error: network not trained
+    }
+    
+    // Validate input dimensions
+    if (n_inputs != net->n_inputs) {
+        return -1.0f; // Error: dimension mismatch
+    }
+    
+    // Apply the model's input normalization
+    if (net->normalization != NORMALIZE_NONE) {
+        memcpy(ctx->input, input, n_inputs * sizeof(float));
+        affine_columns_simd(ctx->input, 1, n_inputs, net->input_offset, net->input_scale);
+        input = ctx->input;
+    }
+    
+    // Compute the forward pass, alternating between the context's buffers
+    for (int l = 0; l < net->n_layers; l++) {
+        float* output = ctx->layer[l & 1];
+        layer_forward(&net->layers[l], input, output);
+        input = output;
+    }
+    
+    // Return output activation, or the most likely class
+    if (net->n_outputs > 1) {
+        int predicted_class;
+        argmax_rows_simd(input, 1, net->n_outputs, &predicted_class);
+        return (float)predicted_class;
+    }
+    return input[0];
+}
+
+// Predict with a network handle (-1 if untrained or mismatched).
+// Uses a stack context, so it is reentrant as well.
+EMSCRIPTEN_KEEPALIVE
+float run_network(NeuralNetwork* model, float* input, int n_inputs) {
+    InferenceContext ctx;
+    return run_network_ctx(model, &ctx, input, n_inputs);
+}
+
+// Scratch floats of run_batch_blocks for blocks of block_rows rows: two
+// ping-pong activation buffers of the widest layer, plus a copy of the input
+// block when the model normalizes its inputs
+static size_t batch_scratch_floats(const NeuralNetwork* net, int block_rows) {
+    int n_buffers = net->normalization != NORMALIZE_NONE ? 3 : 2;
+    return (size_t)n_buffers * block_rows * net->max_width;
+}
+
+// Forward n_rows rows (at most block_rows) with one GEMM per layer; the output
+// layer writes to outputs. scratch holds batch_scratch_floats(net, block_rows).
+static void run_batch_block(const NeuralNetwork* net, float* inputs, int n_rows, float* outputs,
+                            int block_rows, float* scratch) {
+    size_t buffer_floats = (size_t)block_rows * net->max_width;
+    float* activations[2] = { scratch, scratch + buffer_floats };
+    float* block = inputs;
+    if (net->normalization != NORMALIZE_NONE) {
+        float* normalized = scratch + 2 * buffer_floats;
+        memcpy(normalized, inputs, (size_t)n_rows * net->n_inputs * sizeof(float));
+        affine_columns_simd(normalized, n_rows, net->n_inputs, net->input_offset, net->input_scale);
+        block = normalized;
+    }
+    
+    // [rows x n_in] x [n_in x n_out] per layer
+    for (int l = 0; l < net->n_layers; l++) {
+        const DenseLayer* layer = &net->layers[l];
+        float* layer_out = l == net->n_layers - 1 ? outputs : activations[l & 1];
+        layer_forward_batch(layer, block, layer_out, n_rows);
+        block = layer_out;
+    }
+}
+
+// Batch prediction: score n_rows rows of inputs ([n_rows][n_inputs], row-major)
+// into outputs[n_rows] (classifiers: the class probabilities,
+// [n_rows][n_classes]) with blocked SIMD forward passes, one GEMM per layer
+// per block of RUN_BATCH_ROWS rows. The block buffers are sized by the
+// model's widest layer and allocated once per call, so the input
+// normalization is applied to a copy and inputs are not modified. model is a
+// handle from create_network, or NULL for the default network trained by
+// train_ann*. The model is only read, so several threads may score against
+// the same model at once.
+// Returns 0 on success, -1 if the network is not trained, -2 if n_rows < 0,
+// -3 if the block buffers cannot be allocated.
+EMSCRIPTEN_KEEPALIVE
+int run_ann_batch(NeuralNetwork* model, float* inputs, int n_rows, float* outputs) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized || net->workspace == NULL) {
+        return -1; // Error: network not trained
+    }
+    if (n_rows < 0) {
+        return -2; // Error: invalid number of rows
+    }
+    if (n_rows == 0) {
+        return 0;
+    }
+    
+    int block_rows = n_rows < RUN_BATCH_ROWS ? n_rows : RUN_BATCH_ROWS;
+    float* scratch = (float*)ann_malloc(batch_scratch_floats(net, block_rows) * sizeof(float));
+    if (scratch == NULL) {
+        return -3; // Error: out of memory
+    }
+    
+    for (int start = 0; start < n_rows; start += block_rows) {
+        int rows = n_rows - start < block_rows ? n_rows - start : block_rows;
+        run_batch_block(net, &inputs[(size_t)start * net->n_inputs], rows,
+                        &outputs[(size_t)start * net->n_outputs], block_rows, scratch);
+    }
+    
+    free(scratch);
+    return 0;
+}
+
+// Batched class decoding: the predicted class of each of n_rows rows of inputs
+// ([n_rows][n_inputs], row-major) into classes_out[n_rows]. Classifiers pick
+// the most likely class (argmax of the softmax, lowest index on ties); a
+// sigmoid output is read as a binary classifier (1 at 0.5 and above). Rows
+// are scored as in run_ann_batch, one block of RUN_BATCH_ROWS probabilities
+// at a time. model is a handle, or NULL for the default network.
+// Returns 0 on success, -1 if the network is not trained, -2 if n_rows < 0,
+// -3 if the block buffers cannot be allocated.
+EMSCRIPTEN_KEEPALIVE
+int classify_batch(NeuralNetwork* model, float* inputs, int n_rows, int* classes_out) {
+    NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized || net->workspace == NULL) {
+        return -1; // Error: network not trained
+    }
+    if (n_rows < 0) {
+        return -2; // Error: invalid number of rows
+    }
+    if (n_rows == 0) {
+        return 0;
+    }
+    
+    int n_o = net->n_outputs;
+    int block_rows = n_rows < RUN_BATCH_ROWS ? n_rows : RUN_BATCH_ROWS;
+    size_t scratch_floats = batch_scratch_floats(net, block_rows);
+    float* scratch = (float*)ann_malloc((scratch_floats + (size_t)block_rows * n_o) * sizeof(float));
+    if (scratch == NULL) {
+        return -3; // Error: out of memory
+    }
+    float* probs = scratch + scratch_floats;
+    
+    for (int start = 0; start < n_rows; start += block_rows) {
+        int rows = n_rows - start < block_rows ? n_rows - start : block_rows;
+        run_batch_block(net, &inputs[(size_t)start * net->n_inputs], rows, probs, block_rows, scratch);
+        if (n_o > 1) {
+            argmax_rows_simd(probs, rows, n_o, &classes_out[start]);
+        } else {
+            for (int r = 0; r < rows; r++) {
+                classes_out[start + r] = probs[r] >= 0.5f;
+            }
+        }
+    }
+    
+    free(scratch);
+    return 0;
+}
+
+// Copy a network handle's first-layer weights (as [n_hidden][n_inputs]) and
+// output-layer weights (as [n_outputs][units in the last hidden layer]); with
+// one hidden layer these are all the weights
+EMSCRIPTEN_KEEPALIVE
+void get_network_weights(NeuralNetwork* model, float* weights_ih_out, float* weights_ho_out) {
+    const NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is initialized
+    if (!net->is_initialized) {
+        return;
+    }
+    
+    // Copy input-to-hidden weights, transposed to [n_hidden][n_inputs]
+    const DenseLayer* first = &net->layers[0];
+    if (weights_ih_out != NULL) {
+        for (int h = 0; h < first->n_out; h++) {
+            for (int i = 0; i < first->n_in; i++) {
+                weights_ih_out[h * first->n_in + i] = first->weights[i * first->n_out + h];
+            }
+        }
+    }
+    
+    // Copy hidden-to-output weights, transposed to [n_outputs][n_in]
+    const DenseLayer* last = &net->layers[net->n_layers - 1];
+    if (weights_ho_out != NULL) {
+        for (int k = 0; k < last->n_out; k++) {
+            for (int h = 0; h < last->n_in; h++) {
+                weights_ho_out[k * last->n_in + h] = last->weights[h * last->n_out + k];
+            }
+        }
+    }
+}
+
+#ifndef ANN_INFERENCE_ONLY
+// ============================================================================
+// Model compiler: emits a standalone C scorer with the trained weights baked
+// in as constants, every loop unrolled and the activations inlined.
+// ============================================================================
+
+// Append-only text buffer with snprintf semantics: len keeps counting past
+// size so the caller learns the full length required
+typedef struct {
+    char* buf;
+    int size;
+    int len;
+} CodeBuffer;
+
+static void emit(CodeBuffer* cb, const char* fmt, ...) {
+    char* dst = cb->len < cb->size ? cb->buf + cb->len : NULL;
+    size_t room = cb->len < cb->size ? (size_t)(cb->size - cb->len) : 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(dst, room, fmt, args);
+    va_end(args);
+    if (n > 0) {
+        cb->len += n;
+    }
+}
+
+// Emit `static float <name>_exp(float x)`: the scalar form of exp_f32x4
+// (Cephes expf, ann_simd.c), operation for operation, so the exported sigmoid
+// and softmax round like the engine's instead of like libm expf
+static void emit_exp_function(CodeBuffer* cb, const char* name) {
+    emit(cb, "static float %s_exp(float x) {\n", name);
+    emit(cb, "    x = x < -87.0f ? -87.0f : (x > 88.0f ? 88.0f : x);\n");
+    emit(cb, "    const float n = rintf(x * 1.44269504088896341f);\n");
+    emit(cb, "    float r = x - n * 0.693359375f;\n");
+    emit(cb, "    r = r - n * -2.12194440e-4f;\n");
+    emit(cb, "    float p = 1.9875691500e-4f;\n");
+    emit(cb, "    p = p * r + 1.3981999507e-3f;\n");
+    emit(cb, "    p = p * r + 8.3334519073e-3f;\n");
+    emit(cb, "    p = p * r + 4.1665795894e-2f;\n");
+    emit(cb, "    p = p * r + 1.6666665459e-1f;\n");
+    emit(cb, "    p = p * r + 5.0000001201e-1f;\n");
+    emit(cb, "    p = p * r * r + (r + 1.0f);\n");
+    emit(cb, "    union { int i; float f; } scale;\n");
+    emit(cb, "    scale.i = ((int)n + 127) << 23;\n");
+    emit(cb, "    return p * scale.f;\n");
+    emit(cb, "}\n\n");
+}
+
+// Emit `dst = act(dst);` for a hidden activation (0=sigmoid, 1=relu, 2=tanh)
+static void emit_activation(CodeBuffer* cb, const char* name, const char* dst, int activation_type) {
+    switch (activation_type) {
+        case 1:
+            emit(cb, "    %s = %s > 0.0f ? %s : 0.0f;\n", dst, dst, dst);
+            break;
+        case 2:
+            // Same clamped rational approximation as tanh_forward_simd, which
+            // the network was trained with
+            emit(cb, "    %s = %s < -5.0f ? -5.0f : (%s > 5.0f ? 5.0f : %s);\n", dst, dst, dst, dst);
+            emit(cb, "    %s = %s * (27.0f + %s * %s) / (27.0f + 9.0f * %s * %s);\n", dst, dst, dst, dst, dst, dst);
+            break;
+        default:
+            emit(cb, "    %s = 1.0f / (1.0f + %s_exp(-%s));\n", dst, name, dst);
+            break;
+    }
+}
+
+// Constants are printed with 9 significant digits ("%.8e"), which round-trips
+// every float exactly and is always a valid C floating literal.
+static int emit_network_c(const NeuralNetwork* net, const char* name, CodeBuffer* cb) {
+    static const char* activation_names[] = {"sigmoid", "relu", "tanh"};
+    int n_in = net->n_inputs;
+    int last = net->n_layers - 1;
+    
+    emit(cb, "// Generated by Frankenstein Neural Web: %d inputs, hidden", n_in);
+    for (int l = 0; l < last; l++) {
+        emit(cb, "%s %d (%s)", l > 0 ? "," : "", net->layers[l].n_out,
+             activation_names[net->layers[l].activation]);
+    }
+    const DenseLayer* output = &net->layers[last];
+    int n_classes = output->activation == ACTIVATION_SOFTMAX ? output->n_out : 0;
+    if (n_classes > 0) {
+        emit(cb, ", %d outputs (softmax)\n", n_classes);
+        emit(cb, "#include <math.h>\n\n");
+        emit_exp_function(cb, name);
+        emit(cb, "int %s(const float* x, float* probs) {\n", name);
+    } else {
+        emit(cb, ", 1 output (sigmoid)\n");
+        emit(cb, "#include <math.h>\n\n");
+        emit_exp_function(cb, name);
+        emit(cb, "float %s(const float* x) {\n", name);
+    }
+    
+    // Input normalization, same arithmetic as affine_columns_simd
+    int normalized = net->normalization != NORMALIZE_NONE;
+    if (normalized) {
+        for (int i = 0; i < n_in; i++) {
+            emit(cb, "    const float n%d = (x[%d] - %.8ef) * %.8ef;\n",
+                 i, i, net->input_offset[i], net->input_scale[i]);
+        }
+    }
+    
+    // Hidden layers: one straight-line weighted sum per neuron, h<layer>_<unit>
+    for (int l = 0; l < last; l++) {
+        const DenseLayer* layer = &net->layers[l];
+        for (int j = 0; j < layer->n_out; j++) {
+            char var[24];
+            char input[24];
+            snprintf(var, sizeof(var), "h%d_%d", l, j);
+            emit(cb, "    float %s = %.8ef", var, layer->bias[j]);
+            for (int i = 0; i < layer->n_in; i++) {
+                if (l > 0) {
+                    snprintf(input, sizeof(input), "h%d_%d", l - 1, i);
+                } else {
+                    snprintf(input, sizeof(input), normalized ? "n%d" : "x[%d]", i);
+                }
+                emit(cb, "\n        + %.8ef * %s", layer->weights[i * layer->n_out + j], input);
+            }
+            emit(cb, ";\n");
+            emit_activation(cb, name, var, layer->activation);
+        }
+    }
+    
+    // Softmax output layer: logits, then the stable softmax and argmax
+    if (n_classes > 0) {
+        emit(cb, "    float z[%d];\n", n_classes);
+        for (int k = 0; k < n_classes; k++) {
+            emit(cb, "    z[%d] = %.8ef", k, output->bias[k]);
+            for (int h = 0; h < output->n_in; h++) {
+                emit(cb, "\n        + %.8ef * h%d_%d", output->weights[h * n_classes + k], last - 1, h);
+            }
+            emit(cb, ";\n");
+        }
+        emit(cb, "    float m = z[0];\n");
+        emit(cb, "    for (int k = 1; k < %d; k++) m = z[k] > m ? z[k] : m;\n", n_classes);
+        emit(cb, "    float sum = 0.0f;\n");
+        emit(cb, "    for (int k = 0; k < %d; k++) {\n", n_classes);
+        emit(cb, "        z[k] = %s_exp(z[k] - m);\n", name);
+        emit(cb, "        sum += z[k];\n");
+        emit(cb, "    }\n");
+        emit(cb, "    const float inv_sum = 1.0f / sum;\n");
+        emit(cb, "    int best = 0;\n");
+        emit(cb, "    for (int k = 0; k < %d; k++) {\n", n_classes);
+        emit(cb, "        z[k] *= inv_sum;\n");
+        emit(cb, "        if (probs) probs[k] = z[k];\n");
+        emit(cb, "        if (z[k] > z[best]) best = k;\n");
+        emit(cb, "    }\n");
+        emit(cb, "    return best;\n");
+        emit(cb, "}\n");
+        return cb->len;
+    }
+    
+    // Output layer: one sigmoid unit
+    emit(cb, "    float z = %.8ef", output->bias[0]);
+    for (int h = 0; h < output->n_in; h++) {
+        emit(cb, "\n        + %.8ef * h%d_%d", output->weights[h], last - 1, h);
+    }
+    emit(cb, ";\n");
+    emit(cb, "    return 1.0f / (1.0f + %s_exp(-z));\n", name);
+    emit(cb, "}\n");
+    return cb->len;
+}
+
+// Generate C source for a trained model: `float name(const float* x)` returning
+// the same prediction as run_ann within float rounding (the activations use
+// the engine's exp and tanh approximations; only the summation order of the
+// vectorized dot products differs); classifiers get
+// `int name(const float* x, float* probs)`, returning the class and writing
+// the class probabilities to probs unless it is NULL. model
+// is a handle from create_network, or NULL for the default network; name is a
+// C identifier, or NULL for "ann_predict".
+// Writes at most buf_size bytes including the terminating NUL and returns the
+// full source length, so a call with buf_size = 0 sizes the buffer.
+// Returns -1 if the network is not trained, -2 for an invalid name, -3 if the
+// weights are not finite.
+EMSCRIPTEN_KEEPALIVE
+int export_network_c(const NeuralNetwork* model, const char* name, char* buf, int buf_size) {
+    const NeuralNetwork* net = model != NULL ? model : &default_network;
+    
+    // Validate that network is trained
+    if (!net->is_initialized || net->workspace == NULL) {
+        return -1; // Error: network not trained
+    }
+    
+    // Validate the function name as a C identifier
+    if (name == NULL) {
+        name = "ann_predict";
+    }
+    if (!(name[0] == '_' || (name[0] >= 'a' && name[0] <= 'z') || (name[0] >= 'A' && name[0] <= 'Z'))) {
+        return -2; // Error: invalid function name
+    }
+    for (const char* c = name; *c != '\0'; c++) {
+        if (!(*c == '_' || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9'))) {
+            return -2; // Error: invalid function name
+        }
+    }
+    
+    // Every parameter (and the input transform) must print as a finite literal
+    for (int p = 0; p < net->n_params; p++) {
+        if (!isfinite(net->params[p])) {
+            return -3; // Error: non-finite weights
+        }
+    }
+    for (int i = 0; net->normalization != NORMALIZE_NONE && i < net->n_inputs; i++) {
+        if (!isfinite(net->input_offset[i]) || !isfinite(net->input_scale[i])) {
+            return -3; // Error: non-finite weights
+        }
+    }
+    
+    CodeBuffer cb = {buf, buf != NULL && buf_size > 0 ? buf_size : 0, 0};
+    if (cb.size > 0) {
+        buf[0] = '\0';
+    }
+    return emit_network_c(net, name, &cb);
+}
+#endif // ANN_INFERENCE_ONLY
+
+// ============================================================================
+// Handle-less exports operating on the default network
+// ============================================================================
+
+#ifndef ANN_INFERENCE_ONLY
+// Exported training function v3: mini-batch gradient descent
+// Each batch runs one batched GEMM forward/backward pass and one weight update.
+// Gradients are summed over the batch (learning rate 0.01 per sample, i.e. the
+// linear scaling rule), so batch_size = 1 reproduces train_ann_v2.
+// Additional error codes: -5 invalid batch size, -6 out of memory.
+EMSCRIPTEN_KEEPALIVE
+float train_ann_v3(float* inputs, float* outputs, int n_rows, int n_inputs,
+                   int n_hidden, int activation_type, int batch_size, float* loss_history) {
+    // Parameter validation
+    float config_error = validate_training_config(n_rows, n_inputs, n_hidden, activation_type);
+    if (config_error < 0.0f) {
+        return config_error;
+    }
+    if (batch_size < 1) {
+        return -5.0f; // Error: invalid batch size
+    }
+    
+    NetworkShape shape = single_hidden_shape(n_inputs, n_hidden, activation_type);
+    return train_minibatch(&default_network, inputs, outputs, n_rows, &shape,
+                           batch_size, OPTIMIZER_SGD, 0.01f, 300, 1, loss_history);
+}
+
+// Exported training function v4: mini-batch training with a selectable optimizer
+// optimizer: 0=SGD, 1=Momentum (beta 0.9), 2=RMSProp (rho 0.9), 3=Adam (0.9, 0.999)
+// Gradients are summed over the batch as in train_ann_v3. loss_history, if
+// given, must hold `epochs` floats.
+// Additional error codes: -5 invalid batch size, -6 out of memory,
+// -7 invalid optimizer, -8 invalid learning rate or epoch count.
+EMSCRIPTEN_KEEPALIVE
+float train_ann_v4(float* inputs, float* outputs, int n_rows, int n_inputs,
+                   int n_hidden, int activation_type, int batch_size,
+                   int optimizer, float learning_rate, int epochs, float* loss_history) {
+    return train_network(&default_network, inputs, outputs, n_rows, n_inputs, n_hidden, activation_type,
+                         batch_size, optimizer, learning_rate, epochs, 1, loss_history);
+}
+
+// Exported training function: train_ann_v4 with any stack of hidden layers
+// (hidden_sizes / hidden_activations [n_hidden_layers], see
+// train_network_layers). One hidden layer matches train_ann_v4.
+// Additional error code: -15 invalid layer count or NULL layer arrays.
+EMSCRIPTEN_KEEPALIVE
+float train_ann_layers(float* inputs, float* outputs, int n_rows, int n_inputs,
+                       int n_hidden_layers, const int* hidden_sizes, const int* hidden_activations,
+                       int batch_size, int optimizer, float learning_rate, int epochs, float* loss_history) {
+    return train_network_layers(&default_network, inputs, outputs, n_rows, n_inputs, n_hidden_layers,
+                                hidden_sizes, hidden_activations, batch_size, optimizer, learning_rate,
+                                epochs, 1, loss_history);
+}
+
+// Exported training function: train_ann_layers with a softmax classifier head
+// of n_classes outputs (see train_network_classifier; labels hold class
+// indices). Additional error code: -16 invalid class label.
+EMSCRIPTEN_KEEPALIVE
+float train_ann_classifier(float* inputs, float* labels, int n_rows, int n_inputs, int n_classes,
+                           int n_hidden_layers, const int* hidden_sizes, const int* hidden_activations,
+                           int batch_size, int optimizer, float learning_rate, int epochs, float* loss_history) {
+    return train_network_classifier(&default_network, inputs, labels, n_rows, n_inputs, n_classes,
+                                    n_hidden_layers, hidden_sizes, hidden_activations, batch_size,
+                                    optimizer, learning_rate, epochs, 1, loss_history);
+}
+
+// Exported training function: continue training the default network for
+// `epochs` more epochs on (new) rows from its current weights (see
+// train_network_epochs; -17 if it has not been trained yet)
+EMSCRIPTEN_KEEPALIVE
+float train_ann_epochs(float* inputs, float* outputs, int n_rows, int n_inputs, int batch_size,
+                       int optimizer, float learning_rate, int epochs, float* loss_history) {
+    return train_network_epochs(&default_network, inputs, outputs, n_rows, n_inputs, batch_size,
+                                optimizer, learning_rate, epochs, 1, loss_history);
+}
+
+// Exported training function: one online update of the default network from
+// a batch of new rows (see train_network_step). Returns the batch's mean loss
+// before the update.
+EMSCRIPTEN_KEEPALIVE
+float train_ann_step(float* inputs, float* outputs, int n_rows, int n_inputs, int optimizer, float learning_rate) {
+    return train_network_step(&default_network, inputs, outputs, n_rows, n_inputs, optimizer, learning_rate);
+}
+
+// Exported training function: data-parallel train_ann_v4
+// The rows are split into n_threads contiguous shards. Every step each thread
+// computes gradients for one mini-batch of its shard, the gradients are summed
+// into one update, and the shared weights are updated once. The reduction
+// order is fixed, so results are deterministic for a given thread count, and
+// n_threads = 1 matches train_ann_v4. Builds without ANN_ENABLE_THREADS run
+// on one thread. n_threads is capped at 64 and at n_rows.
+// Additional error codes: as train_ann_v4, plus -9 invalid thread count
+// (-6 also covers failure to start threads).
+EMSCRIPTEN_KEEPALIVE
+float train_ann_parallel(float* inputs, float* outputs, int n_rows, int n_inputs,
+                         int n_hidden, int activation_type, int batch_size,
+                         int optimizer, float learning_rate, int epochs,
+                         int n_threads, float* loss_history) {
+    return train_network(&default_network, inputs, outputs, n_rows, n_inputs, n_hidden, activation_type,
+                         batch_size, optimizer, learning_rate, epochs, n_threads, loss_history);
+}
+
+// Exported training function: Hogwild asynchronous SGD
+// Each of n_threads threads runs per-sample SGD (as train_ann_v2) over its own
+// contiguous shard of the rows, updating the shared weights without locks.
+// Results are not deterministic for n_threads > 1; n_threads = 1 with
+// learning_rate 0.01 and 300 epochs matches train_ann_v2. Builds without
+// ANN_ENABLE_THREADS run on one thread. n_threads is capped at 64 and at n_rows.
+// Error codes: as train_ann_v2, plus -6 out of memory / threads not started,
+// -8 invalid learning rate or epoch count, -9 invalid thread count.
+EMSCRIPTEN_KEEPALIVE
+float train_ann_hogwild(float* inputs, float* outputs, int n_rows, int n_inputs,
+                        int n_hidden, int activation_type, float learning_rate, int epochs,
+                        int n_threads, float* loss_history) {
+    return train_network_hogwild(&default_network, inputs, outputs, n_rows, n_inputs, n_hidden,
+                                 activation_type, learning_rate, epochs, n_threads, loss_history);
+}
+
+#endif // ANN_INFERENCE_ONLY
+
+// Exported prediction function (classifiers: the predicted class index)
+EMSCRIPTEN_KEEPALIVE
+float run_ann(float* input, int n_inputs) {
+    return run_network(&default_network, input, n_inputs);
+}
+
+// Exported weight extraction function
+EMSCRIPTEN_KEEPALIVE
+void get_weights(float* weights_ih_out, float* weights_ho_out) {
+    get_network_weights(&default_network, weights_ih_out, weights_ho_out);
+}
+
+// Exported model loader: restore a model written by save_model into the
+// default network (see load_model), e.g. one trained in a Web Worker's module
+EMSCRIPTEN_KEEPALIVE
+int load_ann_model(const unsigned char* data, int size) {
+    return load_model(&default_network, data, size);
+}
+
+// Exported allocation counter: number of heap allocations made by this module
+// since load. Setup allocates (create_network, create_inference_context,
+// init_network in the training and load calls, the optimizer state and the
+// continued-training buffers), and so does each run_ann_batch, classify_batch
+// and save_model_file call; the count stays constant across training epochs
+// and run_ann, run_network and run_network_ctx calls.
+EMSCRIPTEN_KEEPALIVE
+int get_alloc_count() {
+    return __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
 }
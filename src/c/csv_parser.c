@@ -0,0 +1,400 @@
+// Numeric CSV tokenizer for Frankenstein Neural Web
+// Parses CSV text on the WASM heap straight into a row-major float matrix,
+// replacing the split()-based JavaScript path for all-numeric files. Field
+// and record delimiters are indexed with SIMD (find_csv_delimiters_simd),
+// numbers are parsed in place without copying cells. Files with categorical
+// (non-numeric) cells report CSV_ERROR_NOT_NUMERIC so the caller can fall
+// back to the JavaScript parser and its DataEncoder.
+//
+// Input can be fed in chunks of any size (csv_create / csv_feed /
+// csv_finish), so a file can be streamed through one reusable heap buffer;
+// only a cell split across two chunks is copied.
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#else
+// Native builds (build_native.sh) export symbols from the shared library as-is
+#define EMSCRIPTEN_KEEPALIVE
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+// SIMD delimiter index (ann_simd.c / ann_simd_x86.c)
+extern int find_csv_delimiters_simd(const char* data, int length, int* positions);
+
+// Error codes reported by csv_table_error
+#define CSV_OK                 0
+#define CSV_ERROR_EMPTY_CELL  -1  // error_line / error_col locate the empty cell
+#define CSV_ERROR_COLUMNS     -2  // error_line is the row, error_col the number of columns found
+#define CSV_ERROR_NOT_NUMERIC -3  // error_line / error_col locate the cell
+#define CSV_ERROR_NO_ROWS     -4  // No header or no data rows
+#define CSV_ERROR_MEMORY      -5  // Out of memory
+
+// Bytes indexed per find_csv_delimiters_simd call
+#define CSV_BLOCK_BYTES 4096
+
+// Parsed table plus the tokenizer state
+typedef struct {
+    float* values;       // Row-major [n_rows][n_cols]
+    size_t capacity;     // Allocated floats in values
+    int n_rows;
+    int n_cols;          // Columns per row, taken from the header line
+    int error;           // CSV_OK or a CSV_ERROR_* code
+    int error_line;      // 1-based line of the error (header = line 1)
+    int error_col;       // 1-based column of the error (see error codes)
+
+    int line;            // Line being parsed (0 until the header is found)
+    int col;             // Cells completed in the current line
+    char* pending;       // Start of a cell left unfinished by the previous chunk
+    size_t pending_length;
+    size_t pending_capacity;
+    int positions[CSV_BLOCK_BYTES];  // Delimiter offsets of the current block
+} CsvTable;
+
+// Exact powers of ten representable as doubles
+static const double CSV_POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static int is_csv_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Parse a decimal number ([+-]digits[.digits][(e|E)[+-]digits]) spanning
+// exactly [s, end). Returns 0 for anything else (hex, Infinity, text, ...).
+// Results match JavaScript's Number() followed by Float32Array storage for up
+// to 15 significant digits and exponents within +-22; beyond that they may
+// differ by one float ulp.
+static int parse_float(const char* s, const char* end, float* out) {
+    int negative = 0;
+    if (s < end && (*s == '+' || *s == '-')) {
+        negative = *s == '-';
+        s++;
+    }
+
+    // Up to 19 significant digits are kept exactly in a 64-bit mantissa
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exp10 = 0;
+    int seen_digit = 0;
+    for (; s < end && *s >= '0' && *s <= '9'; s++) {
+        seen_digit = 1;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*s - '0');
+            if (mantissa != 0) digits++;
+        } else {
+            exp10++;
+        }
+    }
+    if (s < end && *s == '.') {
+        s++;
+        for (; s < end && *s >= '0' && *s <= '9'; s++) {
+            seen_digit = 1;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*s - '0');
+                if (mantissa != 0) digits++;
+                exp10--;
+            }
+        }
+    }
+    if (!seen_digit) {
+        return 0;
+    }
+
+    // Optional exponent
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        s++;
+        int exp_negative = 0;
+        if (s < end && (*s == '+' || *s == '-')) {
+            exp_negative = *s == '-';
+            s++;
+        }
+        if (s == end || *s < '0' || *s > '9') {
+            return 0;
+        }
+        int e = 0;
+        for (; s < end && *s >= '0' && *s <= '9'; s++) {
+            if (e < 100000) e = e * 10 + (*s - '0');
+        }
+        exp10 += exp_negative ? -e : e;
+    }
+    if (s != end) {
+        return 0;
+    }
+
+    double value = (double)mantissa;
+    if (mantissa != 0) {
+        if (exp10 >= 0 && exp10 <= 22) {
+            value *= CSV_POW10[exp10];
+        } else if (exp10 < 0 && exp10 >= -22) {
+            value /= CSV_POW10[-exp10];
+        } else {
+            value *= pow(10.0, exp10);
+        }
+    }
+    *out = (float)(negative ? -value : value);
+    return 1;
+}
+
+static void csv_set_error(CsvTable* table, int error, int line, int col) {
+    table->error = error;
+    table->error_line = line;
+    table->error_col = col;
+}
+
+// Make room for one more row of n_cols values
+static int csv_reserve_row(CsvTable* table) {
+    size_t needed = (size_t)(table->n_rows + 1) * table->n_cols;
+    if (needed <= table->capacity) {
+        return 1;
+    }
+    size_t capacity = table->capacity > 0 ? table->capacity * 2 : (size_t)table->n_cols * 1024;
+    while (capacity < needed) {
+        capacity *= 2;
+    }
+    float* values = (float*)realloc(table->values, capacity * sizeof(float));
+    if (values == NULL) {
+        return 0;
+    }
+    table->values = values;
+    table->capacity = capacity;
+    return 1;
+}
+
+// Consume one cell [start, end); row_end is set when it ends a line (a '\n'
+// delimiter or the end of the data). Mirrors parseCSV in app.js: blank lines
+// are skipped (but counted after the header), cells are trimmed, and empty
+// cells and ragged rows are errors.
+static void csv_end_cell(CsvTable* table, const char* start, const char* end, int row_end) {
+    if (table->error != CSV_OK) {
+        return;
+    }
+
+    // Trim surrounding whitespace
+    while (start < end && is_csv_space(*start)) start++;
+    while (end > start && is_csv_space(end[-1])) end--;
+    int empty = start == end;
+
+    // Blank line: nothing but whitespace before the newline
+    if (row_end && table->col == 0 && empty) {
+        if (table->line > 0) {
+            table->line++;
+        }
+        return;
+    }
+
+    // Header line: only its column count is used
+    if (table->line == 0) {
+        table->col++;
+        if (row_end) {
+            table->n_cols = table->col;
+            table->col = 0;
+            table->line = 2;
+        }
+        return;
+    }
+
+    if (empty) {
+        csv_set_error(table, CSV_ERROR_EMPTY_CELL, table->line, table->col + 1);
+        return;
+    }
+
+    float value;
+    if (!parse_float(start, end, &value)) {
+        csv_set_error(table, CSV_ERROR_NOT_NUMERIC, table->line, table->col + 1);
+        return;
+    }
+
+    // Surplus cells of a ragged row are validated but not stored
+    if (table->col < table->n_cols) {
+        if (table->col == 0 && !csv_reserve_row(table)) {
+            csv_set_error(table, CSV_ERROR_MEMORY, table->line, 1);
+            return;
+        }
+        table->values[(size_t)table->n_rows * table->n_cols + table->col] = value;
+    }
+    table->col++;
+
+    if (row_end) {
+        if (table->col != table->n_cols) {
+            csv_set_error(table, CSV_ERROR_COLUMNS, table->line, table->col);
+            return;
+        }
+        table->n_rows++;
+        table->col = 0;
+        table->line++;
+    }
+}
+
+// Append [start, end) to the unfinished cell carried over to the next chunk
+static int csv_append_pending(CsvTable* table, const char* start, const char* end) {
+    size_t length = (size_t)(end - start);
+    size_t needed = table->pending_length + length;
+    if (needed > table->pending_capacity) {
+        size_t capacity = table->pending_capacity > 0 ? table->pending_capacity * 2 : 64;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        char* pending = (char*)realloc(table->pending, capacity);
+        if (pending == NULL) {
+            return 0;
+        }
+        table->pending = pending;
+        table->pending_capacity = capacity;
+    }
+    memcpy(table->pending + table->pending_length, start, length);
+    table->pending_length = needed;
+    return 1;
+}
+
+// Create an empty table for incremental parsing with csv_feed / csv_finish.
+// Returns NULL if it cannot be allocated. Free with csv_table_free.
+EMSCRIPTEN_KEEPALIVE
+CsvTable* csv_create(void) {
+    return (CsvTable*)calloc(1, sizeof(CsvTable));
+}
+
+// Parse the next chunk of CSV text (UTF-8 or ASCII, length bytes). Chunks
+// may split cells and lines anywhere; the data is not referenced after the
+// call returns, so the caller can reuse its buffer for the next chunk.
+// Returns CSV_OK or the table's error code (later chunks are then ignored,
+// so the caller can stop reading).
+EMSCRIPTEN_KEEPALIVE
+int csv_feed(CsvTable* table, const char* data, int length) {
+    int cell_start = 0;
+    for (int block = 0; block < length && table->error == CSV_OK; block += CSV_BLOCK_BYTES) {
+        int block_length = length - block < CSV_BLOCK_BYTES ? length - block : CSV_BLOCK_BYTES;
+        int count = find_csv_delimiters_simd(&data[block], block_length, table->positions);
+
+        for (int k = 0; k < count; k++) {
+            int pos = block + table->positions[k];
+            int row_end = data[pos] == '\n';
+            if (table->pending_length > 0) {
+                // Finish the cell started in an earlier chunk
+                if (!csv_append_pending(table, &data[cell_start], &data[pos])) {
+                    csv_set_error(table, CSV_ERROR_MEMORY, table->line, table->col + 1);
+                    break;
+                }
+                csv_end_cell(table, table->pending, table->pending + table->pending_length, row_end);
+                table->pending_length = 0;
+            } else {
+                csv_end_cell(table, &data[cell_start], &data[pos], row_end);
+            }
+            cell_start = pos + 1;
+        }
+    }
+
+    // Carry the unfinished cell over to the next chunk
+    if (table->error == CSV_OK && cell_start < length &&
+        !csv_append_pending(table, &data[cell_start], &data[length])) {
+        csv_set_error(table, CSV_ERROR_MEMORY, table->line, table->col + 1);
+    }
+    return table->error;
+}
+
+// Complete parsing after the last chunk. The first non-blank line is the
+// header; every following non-blank line must have the same number of
+// numeric cells. Returns CSV_OK or the table's error code.
+EMSCRIPTEN_KEEPALIVE
+int csv_finish(CsvTable* table) {
+    // The last line may end without a newline
+    const char* tail = table->pending != NULL ? table->pending : "";
+    csv_end_cell(table, tail, tail + table->pending_length, 1);
+
+    free(table->pending);
+    table->pending = NULL;
+    table->pending_length = 0;
+    table->pending_capacity = 0;
+
+    if (table->error == CSV_OK && table->n_rows == 0) {
+        csv_set_error(table, CSV_ERROR_NO_ROWS, table->line, 0);
+    }
+    return table->error;
+}
+
+// Parse a complete CSV text in one call (csv_create + csv_feed + csv_finish).
+// Returns NULL only if the table itself cannot be allocated; check
+// csv_table_error for parse errors. Free with csv_table_free.
+EMSCRIPTEN_KEEPALIVE
+CsvTable* csv_parse(const char* data, int length) {
+    CsvTable* table = csv_create();
+    if (table == NULL) {
+        return NULL;
+    }
+    csv_feed(table, data, length);
+    csv_finish(table);
+    return table;
+}
+
+// Row-major [rows][cols] values of a parsed table (valid until csv_table_free)
+EMSCRIPTEN_KEEPALIVE
+float* csv_table_values(const CsvTable* table) {
+    return table->values;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int csv_table_rows(const CsvTable* table) {
+    return table->n_rows;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int csv_table_cols(const CsvTable* table) {
+    return table->n_cols;
+}
+
+// Rearrange a parsed [rows][x1..xN, y] table in place into the training
+// layout: inputs [rows][N] (at csv_table_values) followed by the targets
+// [rows] (at csv_table_values + rows * N), so the matrix can be trained on
+// without copying it out. Only the target column is buffered.
+// Returns CSV_OK or CSV_ERROR_MEMORY (the table is left unchanged)
+EMSCRIPTEN_KEEPALIVE
+int csv_table_split_xy(CsvTable* table) {
+    int n_inputs = table->n_cols - 1;
+    float* targets = (float*)malloc((size_t)table->n_rows * sizeof(float));
+    if (targets == NULL) {
+        return CSV_ERROR_MEMORY;
+    }
+
+    for (int r = 0; r < table->n_rows; r++) {
+        targets[r] = table->values[(size_t)r * table->n_cols + n_inputs];
+    }
+    // Row r moves down to r * N, never past its own (already read) slot
+    for (int r = 1; r < table->n_rows; r++) {
+        memmove(table->values + (size_t)r * n_inputs,
+                table->values + (size_t)r * table->n_cols,
+                (size_t)n_inputs * sizeof(float));
+    }
+    memcpy(table->values + (size_t)table->n_rows * n_inputs, targets,
+           (size_t)table->n_rows * sizeof(float));
+    free(targets);
+    return CSV_OK;
+}
+
+// CSV_OK (0) or a negative CSV_ERROR_* code
+EMSCRIPTEN_KEEPALIVE
+int csv_table_error(const CsvTable* table) {
+    return table->error;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int csv_table_error_line(const CsvTable* table) {
+    return table->error_line;
+}
+
+EMSCRIPTEN_KEEPALIVE
+int csv_table_error_col(const CsvTable* table) {
+    return table->error_col;
+}
+
+// Free a table and its values (NULL is ignored)
+EMSCRIPTEN_KEEPALIVE
+void csv_table_free(CsvTable* table) {
+    if (table == NULL) {
+        return;
+    }
+    free(table->values);
+    free(table->pending);
+    free(table);
+}
@@ -2,9 +2,30 @@
 
 let wasm = null;
 let parsedData = null;
+let trainingData = null;  // parsedData of the training run in progress, if its features are heap-resident
 let isNetworkTrained = false;
+let trainedClassCount = 0; // Classes of the softmax output layer (0 = single sigmoid output)
 let predictionHistory = [];
 let lossGraph = null;
+let trainingCancelled = false; // Set by the Cancel button; checked between training slices
+let trainWorker = null; // Dedicated training worker (train_worker.js), or null to train on the page
+
+// Input normalization methods (normalize_columns / set_network_normalization)
+const NORMALIZE_NONE = 0;
+const NORMALIZE_ZSCORE = 1;
+const NORMALIZE_MINMAX = 2;
+
+// Largest input layer accepted by the C engine (MAX_INPUT_FEATURES)
+const MAX_INPUT_FEATURES = 1024;
+
+// Training time per animation frame for resumable runs (train_network_run_for_ms),
+// leaving the rest of a 60 fps frame for rendering and input
+const TRAIN_SLICE_MS = 10;
+
+// Worker training stream (TrainStream): epoch records kept for the page, and
+// how often the live weight heatmap is redrawn from the streamed weights
+const TRAIN_STREAM_CAPACITY = 1024;
+const LIVE_WEIGHTS_INTERVAL_MS = 250;
 
 // LossGraph class for visualizing training loss over epochs
 class LossGraph {
@@ -505,6 +526,21 @@ function normalizeIrisData(rawSamples) {
     };
 }
 
+// Start the training worker; it reports 'ready' once its own WASM module has
+// loaded with resumable training, and until then training stays on the page
+function startTrainWorker() {
+    const worker = new Worker('train_worker.js');
+    worker.onmessage = (e) => {
+        if (e.data.type === 'ready') {
+            trainWorker = worker;
+            updateStatus('[SYSTEM] Training worker ready (live loss stream over shared memory)');
+        } else {
+            worker.terminate();
+        }
+    };
+    worker.onerror = () => worker.terminate();
+}
+
 // Initialize WASM module
 async function initWASM() {
     try {
@@ -514,18 +550,66 @@ async function initWASM() {
         // Feature detection: check if train_ann_v2 is available
         const hasV2 = typeof module._train_ann_v2 !== 'undefined';
         const hasGetWeights = typeof module._get_weights !== 'undefined';
+        const hasBatchPredict = typeof module._run_ann_batch !== 'undefined';
+        const hasCodegen = typeof module._export_network_c !== 'undefined' && typeof module.UTF8ToString === 'function';
+        const hasCSVParser = typeof module._csv_parse !== 'undefined' && typeof module.HEAPU8 !== 'undefined';
+        const hasNormalization = typeof module._normalize_columns !== 'undefined';
+        const hasLayers = typeof module._train_ann_layers !== 'undefined';
+        const hasClassifier = typeof module._train_ann_classifier !== 'undefined' && typeof module._classify_batch !== 'undefined';
+        const hasTrainSession = typeof module._train_network_begin !== 'undefined';
         
         wasm = {
             train: module.cwrap('train_ann', 'number', ['number', 'number', 'number', 'number']),
             train_v2: hasV2 ? module.cwrap('train_ann_v2', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number']) : null,
+            train_layers: hasLayers ? module.cwrap('train_ann_layers', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']) : null,
+            train_classifier: hasClassifier ? module.cwrap('train_ann_classifier', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']) : null,
+            classify_batch: hasClassifier ? module.cwrap('classify_batch', 'number', ['number', 'number', 'number', 'number']) : null,
+            session: hasTrainSession ? {
+                begin: module.cwrap('train_network_begin', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']),
+                runForMs: module.cwrap('train_network_run_for_ms', 'number', ['number', 'number']),
+                finish: module.cwrap('train_network_finish', 'number', ['number'])
+            } : null,
             predict: module.cwrap('run_ann', 'number', ['number', 'number']),
+            predict_batch: hasBatchPredict ? module.cwrap('run_ann_batch', 'number', ['number', 'number', 'number', 'number']) : null,
             get_weights: hasGetWeights ? module.cwrap('get_weights', null, ['number', 'number']) : null,
+            export_c: hasCodegen ? module.cwrap('export_network_c', 'number', ['number', 'number', 'number', 'number']) : null,
+            UTF8ToString: hasCodegen ? module.UTF8ToString : null,
+            normalize: hasNormalization ? module.cwrap('normalize_columns', 'number', ['number', 'number', 'number', 'number', 'number', 'number']) : null,
+            set_normalization: hasNormalization ? module.cwrap('set_network_normalization', 'number', ['number', 'number', 'number', 'number']) : null,
+            load_model: typeof module._load_ann_model !== 'undefined' ? module.cwrap('load_ann_model', 'number', ['number', 'number']) : null,
+            csv: hasCSVParser ? {
+                create: module.cwrap('csv_create', 'number', []),
+                feed: module.cwrap('csv_feed', 'number', ['number', 'number', 'number']),
+                finish: module.cwrap('csv_finish', 'number', ['number']),
+                values: module.cwrap('csv_table_values', 'number', ['number']),
+                rows: module.cwrap('csv_table_rows', 'number', ['number']),
+                cols: module.cwrap('csv_table_cols', 'number', ['number']),
+                error: module.cwrap('csv_table_error', 'number', ['number']),
+                errorLine: module.cwrap('csv_table_error_line', 'number', ['number']),
+                errorCol: module.cwrap('csv_table_error_col', 'number', ['number']),
+                splitXY: module.cwrap('csv_table_split_xy', 'number', ['number']),
+                free: module.cwrap('csv_table_free', null, ['number'])
+            } : null,
             malloc: module._malloc,
             free: module._free,
-            HEAPF32: module.HEAPF32,
+            // Heap views are replaced when memory grows, so always read them from the module
+            get HEAPF32() { return module.HEAPF32; },
+            get HEAPU8() { return module.HEAPU8; },
             hasV2Features: hasV2 && hasGetWeights
         };
         
+        // Worker training needs shared memory (a cross-origin isolated page) and
+        // a way to load the worker's model back into this module
+        if (wasm.session && wasm.load_model && typeof Worker !== 'undefined' &&
+            typeof SharedArrayBuffer !== 'undefined' && self.crossOriginIsolated) {
+            startTrainWorker();
+        }
+        
+        // Model compiler export is optional
+        if (wasm.export_c) {
+            document.getElementById('exportCButton').style.display = '';
+        }
+        
         // Log feature availability
         if (wasm.hasV2Features) {
             updateStatus('[SYSTEM] WASM module initialized with v2 features (configurable architecture, visualizations)');
@@ -551,35 +635,45 @@ async function initWASM() {
     }
 }
 
-// CSV parsing and validation with mixed data type support
-function parseCSV(fileContent) {
-    const lines = fileContent.trim().split('\n');
-    if (lines.length < 2) {
-        return { error: 'CSV file must contain header and at least one data row' };
-    }
-    
-    const headers = lines[0].split(',').map(h => h.trim());
-    
-    // Validate header pattern: x1, x2, ..., xN, y
+// Validate the header pattern: x1, x2, ..., xN, y
+// Returns an error message, or null if the headers are valid
+function validateCSVHeaders(headers) {
     const inputHeaders = headers.slice(0, -1);
     const outputHeader = headers[headers.length - 1];
     
     if (outputHeader !== 'y') {
-        return { error: 'Last column must be "y"' };
+        return 'Last column must be "y"';
     }
     
     for (let i = 0; i < inputHeaders.length; i++) {
         if (inputHeaders[i] !== `x${i + 1}`) {
-            return { error: `Column ${i + 1} must be "x${i + 1}", found "${inputHeaders[i]}"` };
+            return `Column ${i + 1} must be "x${i + 1}", found "${inputHeaders[i]}"`;
         }
     }
     
-    if (inputHeaders.length < 1 || inputHeaders.length > 10) {
-        return { error: 'Must have 1-10 input columns (x1 to x10)' };
+    if (inputHeaders.length < 1 || inputHeaders.length > MAX_INPUT_FEATURES) {
+        return `Must have 1-${MAX_INPUT_FEATURES} input columns (x1 to x${MAX_INPUT_FEATURES})`;
+    }
+    
+    return null;
+}
+
+// CSV parsing and validation with mixed data type support
+function parseCSV(fileContent) {
+    const lines = fileContent.trim().split('\n');
+    if (lines.length < 2) {
+        return { error: 'CSV file must contain header and at least one data row' };
+    }
+    
+    const headers = lines[0].split(',').map(h => h.trim());
+    const headerError = validateCSVHeaders(headers);
+    if (headerError) {
+        return { error: headerError };
     }
+    const inputHeaders = headers.slice(0, -1);
     
     // Parse data rows (accept mixed types - strings and numbers)
-    const rawData = [];
+    const rawRows = [];
     for (let i = 1; i < lines.length; i++) {
         if (lines[i].trim() === '') continue;
         
@@ -594,16 +688,10 @@ function parseCSV(fileContent) {
             return { error: `Row ${i + 1} has incorrect number of columns (expected ${headers.length}, got ${values.length})` };
         }
         
-        // Create row object with column names as keys
-        const rowObject = {};
-        headers.forEach((header, idx) => {
-            rowObject[header] = values[idx];
-        });
-        
-        rawData.push(rowObject);
+        rawRows.push(values);
     }
     
-    if (rawData.length === 0) {
+    if (rawRows.length === 0) {
         return { error: 'No valid data rows found' };
     }
     
@@ -611,28 +699,18 @@ function parseCSV(fileContent) {
     const encoder = new DataEncoder();
     
     try {
-        // Detect types and encode data
-        encoder.detectTypes(rawData);
-        const encodedData = encoder.encodeDataset(rawData);
-        
-        // Convert encoded data to flat arrays for WASM
-        const inputs = [];
-        const outputs = [];
-        
-        for (const row of encodedData) {
-            // Add input features (all columns except 'y')
-            for (const header of inputHeaders) {
-                inputs.push(row[header]);
-            }
-            // Add output
-            outputs.push(row['y']);
-        }
+        // Detect types and encode data into typed columns
+        encoder.encodeColumns(headers, rawRows);
+        
+        // Row-major inputs (all columns except 'y') and outputs for WASM
+        const inputs = encoder.getRowMajor(inputHeaders);
+        const outputs = encoder.getColumn('y');
         
         return {
             n_inputs: inputHeaders.length,
             inputs: inputs,
             outputs: outputs,
-            n_rows: rawData.length,
+            n_rows: rawRows.length,
             encoder: encoder,
             columnNames: inputHeaders,
             outputColumnName: 'y'
@@ -643,6 +721,160 @@ function parseCSV(fileContent) {
     }
 }
 
+// Native CSV parsing for all-numeric files (csv_parser.c)
+// The file is streamed chunk by chunk through one reusable heap buffer into
+// the C parser, which appends rows to a float matrix in linear memory; the
+// file is never held as a whole string. Resolves to the same result object
+// as parseCSV, or to null when the file has non-numeric cells (or no data
+// rows) and must go through parseCSV instead.
+const CSV_ERROR_EMPTY_CELL = -1;
+const CSV_ERROR_COLUMNS = -2;
+const CSV_ERROR_MEMORY = -5;
+
+// First non-blank line of text, or null if it is not complete yet
+function findCSVHeaderLine(text, complete) {
+    const lines = text.split('\n');
+    const last = complete ? lines.length : lines.length - 1;
+    for (let i = 0; i < last; i++) {
+        if (lines[i].trim() !== '') {
+            return lines[i];
+        }
+    }
+    return null;
+}
+
+async function parseCSVStream(file) {
+    const table = wasm.csv.create();
+    if (!table) {
+        return { error: 'Out of memory while parsing CSV' };
+    }
+    
+    const reader = file.stream().getReader();
+    const decoder = new TextDecoder();
+    let headerText = '';
+    let headers = null;
+    let chunkPtr = 0;
+    let chunkCapacity = 0;
+    let keepTable = false;
+    
+    try {
+        for (;;) {
+            const { done, value } = await reader.read();
+            if (done) {
+                break;
+            }
+            
+            // Only the text up to the header line is decoded
+            if (headers === null) {
+                headerText += decoder.decode(value, { stream: true });
+                const headerLine = findCSVHeaderLine(headerText, false);
+                if (headerLine !== null) {
+                    headers = headerLine.split(',').map(h => h.trim());
+                    const headerError = validateCSVHeaders(headers);
+                    if (headerError) {
+                        reader.cancel();
+                        return { error: headerError };
+                    }
+                }
+            }
+            
+            if (value.length > chunkCapacity) {
+                wasm.free(chunkPtr);
+                chunkPtr = wasm.malloc(value.length);
+                chunkCapacity = chunkPtr ? value.length : 0;
+                if (!chunkPtr) {
+                    reader.cancel();
+                    return { error: 'Out of memory while loading CSV' };
+                }
+            }
+            wasm.HEAPU8.set(value, chunkPtr);
+            
+            // Stop reading at the first error
+            if (wasm.csv.feed(table, chunkPtr, value.length) !== 0) {
+                reader.cancel();
+                break;
+            }
+        }
+        
+        if (headers === null) {
+            const headerLine = findCSVHeaderLine(headerText + decoder.decode(), true);
+            if (headerLine === null) {
+                return null;
+            }
+            headers = headerLine.split(',').map(h => h.trim());
+            const headerError = validateCSVHeaders(headers);
+            if (headerError) {
+                return { error: headerError };
+            }
+        }
+        
+        const error = wasm.csv.finish(table);
+        const line = wasm.csv.errorLine(table);
+        if (error === CSV_ERROR_EMPTY_CELL) {
+            return { error: `Row ${line} contains empty values. Please fill all cells.` };
+        }
+        if (error === CSV_ERROR_COLUMNS) {
+            return { error: `Row ${line} has incorrect number of columns (expected ${headers.length}, got ${wasm.csv.errorCol(table)})` };
+        }
+        if (error === CSV_ERROR_MEMORY) {
+            return { error: 'Out of memory while parsing CSV' };
+        }
+        if (error !== 0 || wasm.csv.cols(table) !== headers.length) {
+            return null;
+        }
+        
+        // Split the row-major [rows][x1..xN, y] matrix into inputs then outputs
+        // in place; training reads it from the heap without a copy
+        if (wasm.csv.splitXY(table) !== 0) {
+            return { error: 'Out of memory while parsing CSV' };
+        }
+        const inputHeaders = headers.slice(0, -1);
+        const n_inputs = inputHeaders.length;
+        const n_rows = wasm.csv.rows(table);
+        const inputsPtr = wasm.csv.values(table);
+        
+        const encoder = new DataEncoder();
+        encoder.setNumericColumns(headers);
+        
+        keepTable = true;
+        return {
+            n_inputs: n_inputs,
+            inputs: null,
+            outputs: null,
+            n_rows: n_rows,
+            table: table,
+            inputsPtr: inputsPtr,
+            outputsPtr: inputsPtr + n_rows * n_inputs * 4,
+            encoder: encoder,
+            columnNames: inputHeaders,
+            outputColumnName: 'y'
+        };
+    } finally {
+        wasm.free(chunkPtr);
+        if (!keepTable) {
+            wasm.csv.free(table);
+        }
+    }
+}
+
+// Free the heap-resident matrix of an uploaded CSV (see parseCSVStream). A
+// training run still reading it frees it when it finishes instead.
+function releaseParsedData(data) {
+    if (!data || !data.table) {
+        return;
+    }
+    if (data === trainingData) {
+        data.released = true;
+        return;
+    }
+    wasm.csv.free(data.table);
+    if (data.transformPtr) {
+        wasm.free(data.transformPtr);
+    }
+    data.table = 0;
+    data.transformPtr = 0;
+}
+
 // Update status terminal
 function updateStatus(message) {
     const terminal = document.getElementById('trainingStatus');
@@ -662,50 +894,67 @@ function updateStatus(message) {
 }
 
 // File upload handling
+// All-numeric files are streamed into the native parser; files with
+// categorical columns are read again as text for parseCSV and the DataEncoder.
 function handleFileUpload(file) {
+    if (wasm && wasm.csv && typeof file.stream === 'function') {
+        parseCSVStream(file)
+            .then(result => result !== null ? result : file.text().then(parseCSV))
+            .then(showParsedCSV)
+            .catch(error => showParsedCSV({ error: `Failed to read file: ${error.message}` }));
+        return;
+    }
+    
     const reader = new FileReader();
     reader.onload = function(e) {
-        const result = parseCSV(e.target.result);
-        const messageDiv = document.getElementById('validationMessage');
-        
-        if (result.error) {
-            messageDiv.textContent = `⚠️ ${result.error}`;
-            messageDiv.className = 'message error';
-            document.getElementById('trainButton').disabled = true;
-            document.getElementById('configControls').style.display = 'none';
-        } else {
-            messageDiv.textContent = `✓ Valid CSV: ${result.n_rows} rows, ${result.n_inputs} inputs`;
-            messageDiv.className = 'message success';
-            document.getElementById('trainButton').disabled = false;
-            
-            // Only show config controls if v2 features are available
-            if (wasm && wasm.hasV2Features) {
-                document.getElementById('configControls').style.display = 'block';
-            }
-            
-            parsedData = result;
-            updateStatus(`[DATA] Loaded ${result.n_rows} samples with ${result.n_inputs} features`);
-            
-            // Display encoding summary if encoder is present
-            if (result.encoder) {
-                const summary = result.encoder.getEncodingSummary();
-                updateStatus('[ENCODING] Data type detection complete:');
-                
-                // Display each line of the summary
-                const summaryLines = summary.split('\n');
-                summaryLines.forEach(line => {
-                    if (line.trim()) {
-                        updateStatus(`[ENCODING] ${line}`);
-                    }
-                });
-            }
-        }
+        showParsedCSV(parseCSV(e.target.result));
     };
     reader.readAsText(file);
 }
 
+// Show the validation result of an uploaded CSV and keep it for training
+function showParsedCSV(result) {
+    const messageDiv = document.getElementById('validationMessage');
+    
+    if (result.error) {
+        messageDiv.textContent = `⚠️ ${result.error}`;
+        messageDiv.className = 'message error';
+        document.getElementById('trainButton').disabled = true;
+        document.getElementById('configControls').style.display = 'none';
+    } else {
+        messageDiv.textContent = `✓ Valid CSV: ${result.n_rows} rows, ${result.n_inputs} inputs`;
+        messageDiv.className = 'message success';
+        document.getElementById('trainButton').disabled = false;
+        
+        // Only show config controls if v2 features are available
+        if (wasm && wasm.hasV2Features) {
+            document.getElementById('configControls').style.display = 'block';
+        }
+        
+        // Uploaded features are z-scored in WASM before training
+        result.normalization = NORMALIZE_ZSCORE;
+        releaseParsedData(parsedData);
+        parsedData = result;
+        updateStatus(`[DATA] Loaded ${result.n_rows} samples with ${result.n_inputs} features`);
+        
+        // Display encoding summary if encoder is present
+        if (result.encoder) {
+            const summary = result.encoder.getEncodingSummary();
+            updateStatus('[ENCODING] Data type detection complete:');
+            
+            // Display each line of the summary
+            const summaryLines = summary.split('\n');
+            summaryLines.forEach(line => {
+                if (line.trim()) {
+                    updateStatus(`[ENCODING] ${line}`);
+                }
+            });
+        }
+    }
+}
+
 // Visualize network weights after training
-function visualizeWeights(n_inputs, n_hidden) {
+function visualizeWeights(n_inputs, n_hidden, n_outputs = 1) {
     if (!wasm || !wasm.get_weights) {
         updateStatus('[ERROR] Weight extraction not available');
         return;
@@ -715,7 +964,7 @@ function visualizeWeights(n_inputs, n_hidden) {
     
     // Calculate sizes for weight matrices
     const weightsIHSize = n_inputs * n_hidden;  // Input-to-hidden weights
-    const weightsHOSize = n_hidden * 1;         // Hidden-to-output weights (always 1 output)
+    const weightsHOSize = n_hidden * n_outputs; // Hidden-to-output weights (one row per output)
     
     // Allocate memory for weight matrices
     const weightsIHPtr = wasm.malloc(weightsIHSize * 4);  // 4 bytes per float
@@ -742,8 +991,8 @@ function visualizeWeights(n_inputs, n_hidden) {
         heatmapIH.setupHoverTooltip(weightsIHCopy, n_hidden, n_inputs);
         
         // Render hidden-to-output weights (rows=output neurons, cols=hidden neurons)
-        heatmapHO.render(weightsHOCopy, 1, n_hidden, 'Hidden → Output Weights');
-        heatmapHO.setupHoverTooltip(weightsHOCopy, 1, n_hidden);
+        heatmapHO.render(weightsHOCopy, n_outputs, n_hidden, 'Hidden → Output Weights');
+        heatmapHO.setupHoverTooltip(weightsHOCopy, n_outputs, n_hidden);
         
         // Show weight heatmap container
         const weightHeatmapContainer = document.getElementById('weightHeatmapContainer');
@@ -774,36 +1023,55 @@ function calculateIrisAccuracy(inputsPtr, outputsPtr, n_rows, n_inputs) {
     let correctPredictions = 0;
     const threshold = 0.5; // Binary classification threshold
     
-    // Allocate memory for a single input sample
-    const singleInputPtr = wasm.malloc(n_inputs * 4);
+    // Count a prediction that matches its label after thresholding
+    const scorePrediction = (prediction, i) => {
+        // Get actual label
+        const actualLabel = wasm.HEAPF32[(outputsPtr / 4) + i];
+        
+        // Convert prediction to binary (0 or 1) using threshold
+        const predictedLabel = prediction >= threshold ? 1 : 0;
+        const actualBinaryLabel = actualLabel >= threshold ? 1 : 0;
+        
+        // Check if prediction matches actual label
+        if (predictedLabel === actualBinaryLabel) {
+            correctPredictions++;
+        }
+    };
     
-    try {
-        // Test each sample in the training set
-        for (let i = 0; i < n_rows; i++) {
-            // Copy single sample from training data
-            const inputOffset = i * n_inputs;
-            for (let j = 0; j < n_inputs; j++) {
-                const value = wasm.HEAPF32[(inputsPtr / 4) + inputOffset + j];
-                wasm.HEAPF32[(singleInputPtr / 4) + j] = value;
+    if (wasm.predict_batch) {
+        // Score the whole training set in one call (default network = handle 0)
+        const predictionsPtr = wasm.malloc(n_rows * 4);
+        
+        try {
+            if (wasm.predict_batch(0, inputsPtr, n_rows, predictionsPtr) < 0) {
+                console.error('Batch prediction failed');
+                return 0;
             }
             
-            // Get prediction
-            const prediction = wasm.predict(singleInputPtr, n_inputs);
-            
-            // Get actual label
-            const actualLabel = wasm.HEAPF32[(outputsPtr / 4) + i];
-            
-            // Convert prediction to binary (0 or 1) using threshold
-            const predictedLabel = prediction >= threshold ? 1 : 0;
-            const actualBinaryLabel = actualLabel >= threshold ? 1 : 0;
-            
-            // Check if prediction matches actual label
-            if (predictedLabel === actualBinaryLabel) {
-                correctPredictions++;
+            const predictions = wasm.HEAPF32.subarray(predictionsPtr / 4, predictionsPtr / 4 + n_rows);
+            for (let i = 0; i < n_rows; i++) {
+                scorePrediction(predictions[i], i);
             }
+        } finally {
+            wasm.free(predictionsPtr);
+        }
+    } else {
+        // Allocate memory for a single input sample
+        const singleInputPtr = wasm.malloc(n_inputs * 4);
+        
+        try {
+            // Test each sample in the training set
+            for (let i = 0; i < n_rows; i++) {
+                // Copy single sample from training data
+                const inputStart = (inputsPtr / 4) + i * n_inputs;
+                wasm.HEAPF32.copyWithin(singleInputPtr / 4, inputStart, inputStart + n_inputs);
+                
+                // Get prediction
+                scorePrediction(wasm.predict(singleInputPtr, n_inputs), i);
+            }
+        } finally {
+            wasm.free(singleInputPtr);
         }
-    } finally {
-        wasm.free(singleInputPtr);
     }
     
     // Calculate accuracy percentage
@@ -811,6 +1079,31 @@ function calculateIrisAccuracy(inputsPtr, outputsPtr, n_rows, n_inputs) {
     return accuracy;
 }
 
+// Training-set accuracy of a softmax classifier: one classify_batch call
+// decodes every row to its most likely class, compared against the labels
+function calculateClassifierAccuracy(inputsPtr, outputsPtr, n_rows) {
+    const classesPtr = wasm.malloc(n_rows * 4);
+    
+    try {
+        if (wasm.classify_batch(0, inputsPtr, n_rows, classesPtr) < 0) {
+            console.error('Batch classification failed');
+            return 0;
+        }
+        
+        const classes = new Int32Array(wasm.HEAPU8.buffer, classesPtr, n_rows);
+        const labels = wasm.HEAPF32.subarray(outputsPtr / 4, outputsPtr / 4 + n_rows);
+        let correctPredictions = 0;
+        for (let i = 0; i < n_rows; i++) {
+            if (classes[i] === labels[i]) {
+                correctPredictions++;
+            }
+        }
+        return (correctPredictions / n_rows) * 100;
+    } finally {
+        wasm.free(classesPtr);
+    }
+}
+
 // Display accuracy with threshold validation
 function displayAccuracy(accuracy) {
     const accuracyDisplay = document.getElementById('accuracyDisplay');
@@ -843,6 +1136,183 @@ function displayAccuracy(accuracy) {
 }
 
 // Training execution
+// Train the default network through a resumable C run, one TRAIN_SLICE_MS
+// slice per animation frame, so the page keeps rendering and responding.
+// Each epoch's loss is plotted as it completes. The Cancel button ends the run
+// after the current slice, keeping the weights reached so far.
+// Returns { loss, epochs } (epochs completed), or { loss: code } when the run
+// could not start.
+async function trainInSlices(inputsPtr, outputsPtr, n_rows, n_inputs, hiddenLayers, layersPtr,
+                             n_outputs, epochs, lossHistoryPtr) {
+    // Per-sample SGD (batch 1, learning rate 0.01) as train_ann_v2
+    const status = wasm.session.begin(0, inputsPtr, outputsPtr, n_rows, n_inputs, hiddenLayers,
+                                      layersPtr, layersPtr + hiddenLayers * 4, n_outputs,
+                                      1, 0, 0.01, epochs, lossHistoryPtr);
+    if (status < 0) {
+        return { loss: status };
+    }
+    
+    const cancelButton = document.getElementById('cancelTrainButton');
+    const finalLossDisplay = document.getElementById('finalLossDisplay');
+    trainingCancelled = false;
+    cancelButton.style.display = 'inline-block';
+    finalLossDisplay.style.display = 'block';
+    
+    let completed = 0;
+    try {
+        while (completed < epochs && !trainingCancelled) {
+            await new Promise(resolve => requestAnimationFrame(resolve));
+            completed = wasm.session.runForMs(0, TRAIN_SLICE_MS);
+            if (completed < 0) {
+                break;
+            }
+            
+            // The heap may have grown, so view the history afresh each frame
+            const lossHistoryArray = new Float32Array(wasm.HEAPF32.buffer, lossHistoryPtr, epochs);
+            for (let epoch = lossGraph.lossHistory.length; epoch < completed; epoch++) {
+                lossGraph.addDataPoint(epoch, lossHistoryArray[epoch]);
+            }
+            lossGraph.render();
+            finalLossDisplay.textContent = `Epoch ${completed} / ${epochs}`;
+        }
+    } finally {
+        cancelButton.style.display = 'none';
+    }
+    
+    return { loss: wasm.session.finish(0), epochs: completed };
+}
+
+// Parameter count of a layer stack (layout of get_network_params)
+function countNetworkParams(n_inputs, hiddenLayers, hiddenSize, n_outputs) {
+    let count = 0;
+    let n_in = n_inputs;
+    for (let l = 0; l < hiddenLayers; l++) {
+        count += n_in * hiddenSize + hiddenSize;
+        n_in = hiddenSize;
+    }
+    return count + n_in * n_outputs + n_outputs;
+}
+
+// Draw the input-to-hidden heatmap from a streamed parameter block, whose
+// first layer is stored input-major ([n_inputs][n_hidden])
+function renderLiveWeights(heatmap, params, n_inputs, n_hidden) {
+    const weights = new Array(n_hidden * n_inputs);
+    for (let h = 0; h < n_hidden; h++) {
+        for (let i = 0; i < n_inputs; i++) {
+            weights[h * n_inputs + i] = params[i * n_hidden + h];
+        }
+    }
+    heatmap.render(weights, n_hidden, n_inputs, 'Input → Hidden Weights (live)');
+}
+
+// Train in the dedicated worker while this thread only draws: each animation
+// frame reads the epochs published since the last frame straight from the
+// shared TrainStream (loss chart, throughput) and, a few times a second, the
+// current weights. The Cancel button raises the stream's cancel flag. The
+// finished model comes back as save_model bytes and replaces the default
+// network here. Returns { loss, epochs } (epochs completed), or { loss: code }
+// on failure.
+async function trainInWorker(inputsPtr, outputsPtr, n_rows, n_inputs, hiddenLayers, hiddenSize,
+                             activationType, n_outputs, epochs) {
+    const nParams = countNetworkParams(n_inputs, hiddenLayers, hiddenSize, n_outputs);
+    const stream = TrainStream.create(TRAIN_STREAM_CAPACITY, nParams);
+    
+    // The worker gets its own copies of the (normalized) heap data
+    const inputs = wasm.HEAPF32.slice(inputsPtr / 4, inputsPtr / 4 + n_rows * n_inputs);
+    const outputs = wasm.HEAPF32.slice(outputsPtr / 4, outputsPtr / 4 + n_rows);
+    let result = null;
+    trainWorker.onmessage = (e) => {
+        result = e.data;
+    };
+    trainWorker.onerror = (e) => {
+        result = { type: 'crash', message: e.message };
+    };
+    trainWorker.postMessage({
+        type: 'train',
+        inputs,
+        outputs,
+        config: { n_rows, n_inputs, hiddenLayers, hiddenSize, activationType, n_outputs, epochs },
+        buffer: stream.buffer
+    }, [inputs.buffer, outputs.buffer]);
+    
+    const cancelButton = document.getElementById('cancelTrainButton');
+    const finalLossDisplay = document.getElementById('finalLossDisplay');
+    trainingCancelled = false;
+    cancelButton.style.display = 'inline-block';
+    finalLossDisplay.style.display = 'block';
+    
+    const heatmap = new WeightHeatmap('weightsIHCanvas');
+    const liveWeights = new Float32Array(nParams);
+    let lastWeightsTime = 0;
+    let nextRecord = 0;
+    let rowsPerSecond = 0;
+    const onEpoch = (epoch, loss, rate) => {
+        lossGraph.addDataPoint(epoch, loss);
+        rowsPerSecond = rate;
+    };
+    
+    try {
+        while (result === null) {
+            await new Promise(resolve => requestAnimationFrame(resolve));
+            if (trainingCancelled) {
+                stream.cancel();
+            }
+            
+            const previous = nextRecord;
+            nextRecord = stream.readEpochs(nextRecord, onEpoch);
+            if (nextRecord !== previous) {
+                lossGraph.render();
+                finalLossDisplay.textContent = `Epoch ${nextRecord} / ${epochs} (${Math.round(rowsPerSecond)} rows/s)`;
+            }
+            
+            const now = performance.now();
+            if (now - lastWeightsTime >= LIVE_WEIGHTS_INTERVAL_MS && stream.readWeights(liveWeights)) {
+                renderLiveWeights(heatmap, liveWeights, n_inputs, hiddenSize);
+                document.getElementById('weightHeatmapContainer').style.display = 'block';
+                lastWeightsTime = now;
+            }
+        }
+    } finally {
+        cancelButton.style.display = 'none';
+    }
+    
+    // Epochs published after the last frame
+    nextRecord = stream.readEpochs(nextRecord, onEpoch);
+    lossGraph.render();
+    if (result.type === 'crash') {
+        // Later runs train on the page
+        trainWorker.terminate();
+        trainWorker = null;
+        throw new Error(`training worker failed: ${result.message}`);
+    }
+    if (result.type !== 'done') {
+        return { loss: result.code };
+    }
+    
+    // Load the trained model into this module for prediction and export
+    const modelBytes = new Uint8Array(result.model);
+    const modelPtr = wasm.malloc(modelBytes.length);
+    try {
+        wasm.HEAPU8.set(modelBytes, modelPtr);
+        const status = wasm.load_model(modelPtr, modelBytes.length);
+        if (status < 0) {
+            return { loss: status };
+        }
+    } finally {
+        wasm.free(modelPtr);
+    }
+    return { loss: result.loss, epochs: result.epochs };
+}
+
+// Upload and dataset selection are locked while a resumable run trains, so
+// parsedData keeps describing the data the model is being trained on
+function setDataInputsLocked(locked) {
+    const datasetSelect = document.getElementById('datasetSelect');
+    document.getElementById('fileInput').disabled = locked;
+    datasetSelect.disabled = locked;
+    document.getElementById('loadDatasetButton').disabled = locked || !datasetSelect.value;
+}
+
 async function trainNetwork() {
     if (!parsedData || !wasm) {
         updateStatus('[ERROR] No data loaded or WASM not initialized');
@@ -858,6 +1328,18 @@ async function trainNetwork() {
     const activationType = useV2 ? parseInt(document.getElementById('activationSelect').value) : 0;
     const hiddenSize = useV2 ? parseInt(document.getElementById('hiddenSizeSlider').value) : 6;
     
+    // Stacked hidden layers (all of hiddenSize neurons) need train_ann_layers
+    const hiddenLayers = useV2 && wasm.train_layers ? parseInt(document.getElementById('hiddenLayersSlider').value) : 1;
+    
+    // A categorical target with 2+ classes gets a softmax output layer (one
+    // probability per class, cross-entropy loss) instead of one sigmoid unit
+    // regressing on the class code
+    const encoder = parsedData.encoder;
+    const n_classes = useV2 && wasm.train_classifier && encoder && encoder.isCategorical(parsedData.outputColumnName)
+        ? encoder.getCategoricalValues(parsedData.outputColumnName).length
+        : 0;
+    const useClassifier = n_classes >= 2;
+    
     // Get activation function name for display
     const activationNames = ['Sigmoid', 'ReLU', 'Tanh'];
     const activationName = activationNames[activationType];
@@ -867,18 +1349,38 @@ async function trainNetwork() {
     updateStatus(`[DATA] Training on ${n_rows} samples with ${n_inputs} features`);
     
     if (useV2) {
-        updateStatus(`[CONFIG] Hidden neurons: ${hiddenSize}, Activation: ${activationName}`);
+        updateStatus(`[CONFIG] Hidden layers: ${hiddenLayers} x ${hiddenSize} neurons, Activation: ${activationName}`);
+        if (useClassifier) {
+            updateStatus(`[CONFIG] Output: softmax over ${n_classes} classes (cross-entropy loss)`);
+        }
     } else {
         updateStatus(`[CONFIG] Hidden neurons: 6 (fixed), Activation: Sigmoid (v1 mode)`);
     }
     
-    // Allocate WASM memory for inputs and outputs
-    const inputsPtr = wasm.malloc(inputs.length * 4);  // 4 bytes per float
-    const outputsPtr = wasm.malloc(outputs.length * 4);
+    // Uploaded CSVs are already in the WASM heap (parseCSVStream); other data
+    // is copied into new buffers
+    const data = parsedData;
+    const heapResident = Boolean(data.table);
+    const inputsPtr = heapResident ? data.inputsPtr : wasm.malloc(inputs.length * 4);  // 4 bytes per float
+    const outputsPtr = heapResident ? data.outputsPtr : wasm.malloc(outputs.length * 4);
+    if (heapResident) {
+        trainingData = data;
+    }
     
     let lossHistoryPtr = null;
+    let layersPtr = null;
     const epochs = 300;
     
+    // Feature normalization transform: offsets then scales, n_inputs floats each.
+    // Heap-resident features are normalized once and keep their transform for retraining.
+    const normalization = wasm.normalize && parsedData.normalization ? parsedData.normalization : NORMALIZE_NONE;
+    if (heapResident && normalization !== NORMALIZE_NONE && !data.transformPtr) {
+        data.transformPtr = wasm.malloc(n_inputs * 2 * 4);
+    }
+    const offsetPtr = normalization === NORMALIZE_NONE ? 0
+        : heapResident ? data.transformPtr : wasm.malloc(n_inputs * 2 * 4);
+    const scalePtr = offsetPtr + n_inputs * 4;
+    
     // Only allocate loss history if v2 is available
     if (useV2) {
         lossHistoryPtr = wasm.malloc(epochs * 4);  // Store loss for each epoch
@@ -896,25 +1398,96 @@ async function trainNetwork() {
     
     try {
         // Copy data to WASM heap
-        wasm.HEAPF32.set(new Float32Array(inputs), inputsPtr / 4);
-        wasm.HEAPF32.set(new Float32Array(outputs), outputsPtr / 4);
+        // Float32Array columns from the encoder are copied once; plain arrays are converted by set()
+        if (!heapResident) {
+            wasm.HEAPF32.set(inputs, inputsPtr / 4);
+            wasm.HEAPF32.set(outputs, outputsPtr / 4);
+        }
+        
+        // Normalize the heap copy of the features in place (one stats pass, one transform pass)
+        if (normalization !== NORMALIZE_NONE && !data.normalized) {
+            const status = wasm.normalize(inputsPtr, n_rows, n_inputs, normalization, offsetPtr, scalePtr);
+            if (status < 0) {
+                updateStatus(`[ERROR] Normalization failed with error code: ${status}`);
+                return;
+            }
+            data.normalized = heapResident;
+            const methodName = normalization === NORMALIZE_ZSCORE ? 'z-score' : 'min-max';
+            updateStatus(`[DATA] Features normalized in WASM (${methodName})`);
+        }
         
         updateStatus('[NEURAL] Initializing synaptic weights...');
         
         let finalLoss;
         
         if (useV2) {
-            // Call training function v2 with configuration parameters
-            finalLoss = wasm.train_v2(inputsPtr, outputsPtr, n_rows, n_inputs, 
-                                            hiddenSize, activationType, lossHistoryPtr);
+            // Resumable runs plot the loss as they go; the blocking calls fill loss_history at once
+            let plottedLive = false;
+            if (wasm.session) {
+                // Layer sizes then activations as int32 arrays
+                layersPtr = wasm.malloc(hiddenLayers * 2 * 4);
+                const layerSpec = new Int32Array(wasm.HEAPU8.buffer, layersPtr, hiddenLayers * 2);
+                layerSpec.fill(hiddenSize, 0, hiddenLayers);
+                layerSpec.fill(activationType, hiddenLayers);
+                document.getElementById('trainButton').disabled = true;
+                document.getElementById('clearButton').style.display = 'none';
+                setDataInputsLocked(true);
+                let run;
+                try {
+                    // outputs hold the category codes 0..n_classes-1 for a classifier
+                    const n_outputs = useClassifier ? n_classes : 1;
+                    if (trainWorker) {
+                        updateStatus('[NEURAL] Training in background worker...');
+                        run = await trainInWorker(inputsPtr, outputsPtr, n_rows, n_inputs, hiddenLayers, hiddenSize,
+                                                  activationType, n_outputs, epochs);
+                    } else {
+                        run = await trainInSlices(inputsPtr, outputsPtr, n_rows, n_inputs, hiddenLayers, layersPtr,
+                                                  n_outputs, epochs, lossHistoryPtr);
+                    }
+                } finally {
+                    document.getElementById('trainButton').disabled = false;
+                    setDataInputsLocked(false);
+                }
+                finalLoss = run.loss;
+                plottedLive = true;
+                if (run.loss >= 0 && run.epochs < epochs) {
+                    updateStatus(`[INFO] Training cancelled after ${run.epochs} of ${epochs} epochs`);
+                }
+            } else if (hiddenLayers > 1 || useClassifier) {
+                // Layer sizes then activations as int32 arrays; per-sample SGD
+                // (batch 1, learning rate 0.01) as train_ann_v2
+                layersPtr = wasm.malloc(hiddenLayers * 2 * 4);
+                const layerSpec = new Int32Array(wasm.HEAPU8.buffer, layersPtr, hiddenLayers * 2);
+                layerSpec.fill(hiddenSize, 0, hiddenLayers);
+                layerSpec.fill(activationType, hiddenLayers);
+                if (useClassifier) {
+                    // outputs hold the target's category codes 0..n_classes-1
+                    finalLoss = wasm.train_classifier(inputsPtr, outputsPtr, n_rows, n_inputs, n_classes,
+                                                      hiddenLayers, layersPtr, layersPtr + hiddenLayers * 4,
+                                                      1, 0, 0.01, epochs, lossHistoryPtr);
+                } else {
+                    finalLoss = wasm.train_layers(inputsPtr, outputsPtr, n_rows, n_inputs, hiddenLayers,
+                                                  layersPtr, layersPtr + hiddenLayers * 4,
+                                                  1, 0, 0.01, epochs, lossHistoryPtr);
+                }
+            } else {
+                // Call training function v2 with configuration parameters
+                finalLoss = wasm.train_v2(inputsPtr, outputsPtr, n_rows, n_inputs, 
+                                                hiddenSize, activationType, lossHistoryPtr);
+            }
             
             // Check for error codes
             if (finalLoss < 0) {
                 const errorMessages = {
-                    '-1': 'Invalid input size (must be 1-10)',
-                    '-2': 'Invalid hidden layer size (must be 2-20)',
+                    '-1': `Invalid input size (must be 1-${MAX_INPUT_FEATURES})`,
+                    '-2': 'Invalid hidden layer size (must be 2-1024)',
                     '-3': 'Invalid activation type (must be 0-2)',
-                    '-4': 'Invalid number of rows'
+                    '-4': 'Invalid number of rows',
+                    '-6': 'Out of memory',
+                    '-11': 'Trained model could not be loaded',
+                    '-18': 'Training run ended unexpectedly',
+                    '-15': 'Invalid layer configuration',
+                    '-16': 'Invalid class label'
                 };
                 const errorMsg = errorMessages[finalLoss.toString()] || 'Unknown error';
                 updateStatus(`[ERROR] Training failed: ${errorMsg}`);
@@ -922,9 +1495,11 @@ async function trainNetwork() {
             }
             
             // Copy loss history from WASM heap and update graph
-            const lossHistoryArray = new Float32Array(wasm.HEAPF32.buffer, lossHistoryPtr, epochs);
-            for (let epoch = 0; epoch < epochs; epoch++) {
-                lossGraph.addDataPoint(epoch, lossHistoryArray[epoch]);
+            if (!plottedLive) {
+                const lossHistoryArray = new Float32Array(wasm.HEAPF32.buffer, lossHistoryPtr, epochs);
+                for (let epoch = 0; epoch < epochs; epoch++) {
+                    lossGraph.addDataPoint(epoch, lossHistoryArray[epoch]);
+                }
             }
             
             // Render the complete loss graph
@@ -949,18 +1524,27 @@ async function trainNetwork() {
         updateStatus('[CORE] Neural pathways established successfully');
         
         // Calculate and display accuracy for Iris dataset (only if v2 available)
-        if (useV2 && parsedData.datasetName === 'Iris Setosa Classification') {
+        if (useV2 && data.datasetName === 'Iris Setosa Classification') {
             const accuracy = calculateIrisAccuracy(inputsPtr, outputsPtr, n_rows, n_inputs);
             displayAccuracy(accuracy);
+        } else if (useClassifier) {
+            displayAccuracy(calculateClassifierAccuracy(inputsPtr, outputsPtr, n_rows));
+        }
+        
+        // Store the transform with the model so run_ann takes raw inputs. Attached
+        // after scoring above, since the heap features are already normalized.
+        if (normalization !== NORMALIZE_NONE) {
+            wasm.set_normalization(0, normalization, offsetPtr, scalePtr);
         }
         
         isNetworkTrained = true;
+        trainedClassCount = useClassifier ? n_classes : 0;
         generatePredictionInputs(n_inputs);
-        displayNetworkConfig(n_inputs, hiddenSize, activationName);
+        displayNetworkConfig(n_inputs, hiddenSize, activationName, hiddenLayers, trainedClassCount);
         
         // Visualize weights after training (only if v2 available)
         if (useV2) {
-            visualizeWeights(n_inputs, hiddenSize);
+            visualizeWeights(n_inputs, hiddenSize, useClassifier ? n_classes : 1);
         } else {
             updateStatus('[INFO] Weight visualization not available in v1 mode');
         }
@@ -973,11 +1557,24 @@ async function trainNetwork() {
         console.error('Training error:', error);
     } finally {
         // Free allocated WASM memory
-        wasm.free(inputsPtr);
-        wasm.free(outputsPtr);
+        if (heapResident) {
+            trainingData = null;
+            if (data.released) {
+                releaseParsedData(data);
+            }
+        } else {
+            wasm.free(inputsPtr);
+            wasm.free(outputsPtr);
+        }
         if (lossHistoryPtr !== null) {
             wasm.free(lossHistoryPtr);
         }
+        if (layersPtr !== null) {
+            wasm.free(layersPtr);
+        }
+        if (offsetPtr && !heapResident) {
+            wasm.free(offsetPtr);
+        }
     }
 }
 
@@ -1056,15 +1653,20 @@ function generatePredictionInputs(n_inputs) {
 }
 
 // Display network configuration
-function displayNetworkConfig(n_inputs, n_hidden, activationName) {
+function displayNetworkConfig(n_inputs, n_hidden, activationName, n_hidden_layers = 1, n_classes = 0) {
     const configDiv = document.getElementById('networkConfig');
-    const n_outputs = 1; // Fixed in C implementation
+    const outputLabel = n_classes > 0
+        ? `Output Layer: ${n_classes} neurons (Softmax)`
+        : 'Output Layer: 1 neuron (Sigmoid)';
+    const hiddenLabel = n_hidden_layers > 1
+        ? `Hidden Layers: ${n_hidden_layers} x ${n_hidden} neurons (${activationName})`
+        : `Hidden Layer: ${n_hidden} neurons (${activationName})`;
     
     configDiv.innerHTML = `
         <strong>Network Architecture:</strong> 
         Input Layer: ${n_inputs} neurons | 
-        Hidden Layer: ${n_hidden} neurons (${activationName}) | 
-        Output Layer: ${n_outputs} neuron (Sigmoid)
+        ${hiddenLabel} | 
+        ${outputLabel}
     `;
     configDiv.style.display = 'block';
 }
@@ -1072,8 +1674,10 @@ function displayNetworkConfig(n_inputs, n_hidden, activationName) {
 // Clear and reset functionality
 function clearAndReset() {
     // Reset state
+    releaseParsedData(parsedData);
     parsedData = null;
     isNetworkTrained = false;
+    trainedClassCount = 0;
     predictionHistory = [];
     
     // Clear loss graph
@@ -1105,10 +1709,49 @@ function clearAndReset() {
     document.getElementById('activationSelect').value = '0';
     document.getElementById('hiddenSizeSlider').value = '6';
     document.getElementById('hiddenSizeValue').textContent = '6';
+    document.getElementById('hiddenLayersSlider').value = '1';
+    document.getElementById('hiddenLayersValue').textContent = '1';
     
     updateStatus('[SYSTEM] Reset complete. Ready for new data.');
 }
 
+// Download the trained network as a standalone C scoring function
+function downloadCScorer() {
+    if (!isNetworkTrained || !wasm || !wasm.export_c) {
+        updateStatus('[ERROR] No trained network to export');
+        return;
+    }
+    
+    // First call sizes the source (default network, default function name)
+    const length = wasm.export_c(0, 0, 0, 0);
+    if (length < 0) {
+        updateStatus(`[ERROR] C export failed with error code: ${length}`);
+        return;
+    }
+    
+    const sourcePtr = wasm.malloc(length + 1);
+    let source;
+    try {
+        wasm.export_c(0, 0, sourcePtr, length + 1);
+        source = wasm.UTF8ToString(sourcePtr);
+    } finally {
+        wasm.free(sourcePtr);
+    }
+    
+    // Create download link
+    const blob = new Blob([source], { type: 'text/x-c' });
+    const url = window.URL.createObjectURL(blob);
+    const a = document.createElement('a');
+    a.href = url;
+    a.download = 'frankenstein_scorer.c';
+    document.body.appendChild(a);
+    a.click();
+    document.body.removeChild(a);
+    window.URL.revokeObjectURL(url);
+    
+    updateStatus(`[EXPORT] Downloaded C scorer (${length} bytes, function ann_predict)`);
+}
+
 // Download prediction results
 function downloadResults() {
     if (predictionHistory.length === 0) {
@@ -1148,8 +1791,8 @@ function makePrediction() {
         return;
     }
     
-    // Validate that Iris predictions use normalized inputs
-    if (parsedData.datasetName === 'Iris Setosa Classification') {
+    // Validate that Iris predictions use normalized inputs (JS normalization fallback)
+    if (parsedData.datasetName === 'Iris Setosa Classification' && parsedData.normalizationStats) {
         // Iris dataset should have normalized inputs stored
         if (!parsedData.inputs || parsedData.inputs.length === 0) {
             updateStatus('[ERROR] Iris dataset not properly normalized');
@@ -1233,14 +1876,37 @@ function makePrediction() {
         // Copy input values to WASM heap
         wasm.HEAPF32.set(new Float32Array(inputValues), inputPtr / 4);
         
-        // Call run_ann function
-        const prediction = wasm.predict(inputPtr, inputValues.length);
+        // Classifiers: score the class probabilities and keep the most likely
+        // class; otherwise call run_ann for the sigmoid output
+        let prediction;
+        let classProbability = null;
+        if (trainedClassCount > 0) {
+            const probsPtr = wasm.malloc(trainedClassCount * 4);
+            try {
+                wasm.predict_batch(0, inputPtr, 1, probsPtr);
+                const probs = wasm.HEAPF32.subarray(probsPtr / 4, probsPtr / 4 + trainedClassCount);
+                prediction = 0;
+                for (let k = 1; k < trainedClassCount; k++) {
+                    if (probs[k] > probs[prediction]) {
+                        prediction = k;
+                    }
+                }
+                classProbability = probs[prediction];
+            } finally {
+                wasm.free(probsPtr);
+            }
+        } else {
+            prediction = wasm.predict(inputPtr, inputValues.length);
+        }
         
         // Decode output if it's categorical
         let displayValue;
         let decodedOutput = null;
         
-        if (encoder && encoder.isCategorical(parsedData.outputColumnName)) {
+        if (classProbability !== null) {
+            decodedOutput = encoder.decodeValue(parsedData.outputColumnName, prediction);
+            displayValue = `${decodedOutput} (probability: ${classProbability.toFixed(4)})`;
+        } else if (encoder && encoder.isCategorical(parsedData.outputColumnName)) {
             decodedOutput = encoder.decodeValue(parsedData.outputColumnName, prediction);
             displayValue = `${decodedOutput} (confidence: ${prediction.toFixed(4)})`;
         } else {
@@ -1290,8 +1956,17 @@ function loadPreloadedDataset(datasetKey) {
     
     // Prepare data based on dataset type
     let inputs, outputs, normalizationStats = null;
-    
-    if (dataset.needsNormalization && dataset.data.rawSamples) {
+    let normalization = NORMALIZE_NONE;
+    
+    if (dataset.needsNormalization && dataset.data.rawSamples && wasm.normalize) {
+        // Raw Iris features; min-max normalized in WASM at training time and
+        // stored with the model, so predictions take raw measurements
+        const n_features = dataset.data.n_inputs;
+        inputs = dataset.data.rawSamples.flatMap(sample => sample.slice(0, n_features));
+        outputs = dataset.data.rawSamples.map(sample => sample[n_features]);
+        normalization = NORMALIZE_MINMAX;
+        updateStatus('[DATA] Iris features will be normalized to [0,1] in WASM');
+    } else if (dataset.needsNormalization && dataset.data.rawSamples) {
         // Normalize Iris dataset
         const normalized = normalizeIrisData(dataset.data.rawSamples);
         inputs = normalized.inputs;
@@ -1310,6 +1985,7 @@ function loadPreloadedDataset(datasetKey) {
     }
     
     // Create parsedData object compatible with training function
+    releaseParsedData(parsedData);
     parsedData = {
         n_inputs: dataset.data.n_inputs,
         inputs: inputs,
@@ -1319,7 +1995,8 @@ function loadPreloadedDataset(datasetKey) {
         columnNames: dataset.featureNames,
         outputColumnName: 'y',
         datasetName: dataset.name,
-        normalizationStats: normalizationStats
+        normalizationStats: normalizationStats,
+        normalization: normalization
     };
     
     // Update UI
@@ -1416,7 +2093,9 @@ document.addEventListener('DOMContentLoaded', function() {
     
     // Click to upload
     uploadArea.addEventListener('click', function() {
-        fileInput.click();
+        if (!fileInput.disabled) {
+            fileInput.click();
+        }
     });
     
     // Drag and drop
@@ -1432,7 +2111,7 @@ document.addEventListener('DOMContentLoaded', function() {
     uploadArea.addEventListener('drop', function(e) {
         e.preventDefault();
         uploadArea.style.background = '';
-        if (e.dataTransfer.files.length > 0) {
+        if (!fileInput.disabled && e.dataTransfer.files.length > 0) {
             handleFileUpload(e.dataTransfer.files[0]);
         }
     });
@@ -1446,9 +2125,17 @@ document.addEventListener('DOMContentLoaded', function() {
     // Clear button
     document.getElementById('clearButton').addEventListener('click', clearAndReset);
     
+    // Cancel a resumable training run after its current slice
+    document.getElementById('cancelTrainButton').addEventListener('click', function() {
+        trainingCancelled = true;
+    });
+    
     // Download button
     document.getElementById('downloadButton').addEventListener('click', downloadResults);
     
+    // Export C scorer button
+    document.getElementById('exportCButton').addEventListener('click', downloadCScorer);
+    
     // Dataset selector
     datasetSelect.addEventListener('change', function() {
         const selectedDataset = datasetSelect.value;
@@ -1477,6 +2164,14 @@ document.addEventListener('DOMContentLoaded', function() {
         hiddenSizeValue.textContent = this.value;
     });
     
+    // Hidden layer count slider
+    const hiddenLayersSlider = document.getElementById('hiddenLayersSlider');
+    const hiddenLayersValue = document.getElementById('hiddenLayersValue');
+    
+    hiddenLayersSlider.addEventListener('input', function() {
+        hiddenLayersValue.textContent = this.value;
+    });
+    
     // Instructions toggle
     const toggleInstructions = document.getElementById('toggleInstructions');
     const instructionsContent = document.getElementById('instructionsContent');
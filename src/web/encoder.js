@@ -16,126 +16,160 @@ class DataEncoder {
         
         // Stores column names in order
         this.columnNames = [];
+        
+        // Encoded Float32Array per column (in columnNames order)
+        this.columns = [];
     }
 
     /**
-     * Detects whether each column contains numeric or categorical data
-     * @param {Array<Object>} data - Array of row objects with column names as keys
-     * @returns {Object} Column types mapping
+     * Encodes a dataset into one Float32Array per column in a single pass.
+     * Column types are detected on the way: a column stays numeric until its
+     * first non-numeric cell, then the cells seen so far are interned too.
+     * Categorical values are interned through a Map and finally renumbered
+     * in sorted order, so codes do not depend on row order.
+     * @param {Array<string>} columnNames - Column names in order
+     * @param {Array<Array<string>>} rows - Cell strings of each row, in column order
+     * @returns {Array<Float32Array>} Encoded columns (also kept for getColumn/getRowMajor)
      */
-    detectTypes(data) {
-        if (!data || data.length === 0) {
-            throw new Error('Cannot detect types: data is empty');
+    encodeColumns(columnNames, rows) {
+        if (!rows || rows.length === 0) {
+            throw new Error('Cannot encode: data is empty');
         }
 
-        // Get column names from first row
-        this.columnNames = Object.keys(data[0]);
+        const n_rows = rows.length;
+        const n_cols = columnNames.length;
+        this.columnNames = [...columnNames];
+        this.columnTypes = {};
+        this.encodingMaps = {};
+        this.decodingMaps = {};
+        this.columns = [];
 
-        // Check each column
-        for (const columnName of this.columnNames) {
-            let isNumeric = true;
+        // Per column: encoded values and, once categorical, value -> provisional code
+        const interned = new Array(n_cols).fill(null);
+        for (let c = 0; c < n_cols; c++) {
+            this.columns.push(new Float32Array(n_rows));
+        }
 
-            // Check all values in this column
-            for (const row of data) {
-                const value = row[columnName];
-                
-                // Skip empty values for now
-                if (value === null || value === undefined || value === '') {
-                    continue;
+        for (let r = 0; r < n_rows; r++) {
+            const row = rows[r];
+            for (let c = 0; c < n_cols; c++) {
+                const value = row[c];
+                if (interned[c] === null) {
+                    const numValue = Number(value);
+                    if (!isNaN(numValue)) {
+                        this.columns[c][r] = numValue;
+                        continue;
+                    }
+                    // First non-numeric cell: intern the rows already seen
+                    interned[c] = new Map();
+                    for (let k = 0; k < r; k++) {
+                        this.columns[c][k] = this._intern(interned[c], rows[k][c]);
+                    }
                 }
+                this.columns[c][r] = this._intern(interned[c], value);
+            }
+        }
 
-                // Try to parse as number
-                const numValue = Number(value);
-                
-                // If parsing fails or results in NaN, it's categorical
-                if (isNaN(numValue)) {
-                    isNumeric = false;
-                    break;
-                }
+        for (let c = 0; c < n_cols; c++) {
+            const columnName = this.columnNames[c];
+            if (interned[c] === null) {
+                this.columnTypes[columnName] = 'numeric';
+                continue;
+            }
+            this.columnTypes[columnName] = 'categorical';
+
+            // Renumber provisional codes (first-seen order) in sorted value order
+            const values = Array.from(interned[c].keys());
+            const sortedValues = [...values].sort();
+            const encodingMap = {};
+            const decodingMap = {};
+            sortedValues.forEach((value, code) => {
+                encodingMap[value] = code;
+                decodingMap[code] = value;
+            });
+            const remap = new Float32Array(values.length);
+            values.forEach((value, provisional) => {
+                remap[provisional] = encodingMap[value];
+            });
+
+            // Empty cells were interned as -1 and encode to 0, like encodeValue
+            const column = this.columns[c];
+            for (let r = 0; r < n_rows; r++) {
+                column[r] = column[r] < 0 ? 0 : remap[column[r]];
             }
 
-            this.columnTypes[columnName] = isNumeric ? 'numeric' : 'categorical';
+            this.encodingMaps[columnName] = encodingMap;
+            this.decodingMaps[columnName] = decodingMap;
         }
 
-        return this.columnTypes;
+        return this.columns;
     }
 
     /**
-     * Encodes a complete dataset, converting categorical values to numeric codes
-     * @param {Array<Object>} data - Array of row objects
-     * @returns {Array<Object>} Encoded data with all numeric values
+     * Returns the provisional code of a categorical value, adding it if new
+     * @private
+     * @param {Map<string, number>} map - Value to provisional code map of the column
+     * @param {*} value - Cell value
+     * @returns {number} Provisional code, or -1 for an empty value
      */
-    encodeDataset(data) {
-        if (!data || data.length === 0) {
-            throw new Error('Cannot encode: data is empty');
+    _intern(map, value) {
+        if (value === null || value === undefined || value === '') {
+            return -1;
         }
-
-        // Detect types if not already done
-        if (Object.keys(this.columnTypes).length === 0) {
-            this.detectTypes(data);
+        const stringValue = String(value);
+        let code = map.get(stringValue);
+        if (code === undefined) {
+            code = map.size;
+            map.set(stringValue, code);
         }
+        return code;
+    }
 
-        // Build encoding maps for categorical columns
-        for (const columnName of this.columnNames) {
-            if (this.columnTypes[columnName] === 'categorical') {
-                this._buildEncodingMap(columnName, data);
-            }
+    /**
+     * Gets an encoded column produced by encodeColumns
+     * @param {string} columnName - Name of the column
+     * @returns {Float32Array} Encoded values, one per row
+     */
+    getColumn(columnName) {
+        const index = this.columnNames.indexOf(columnName);
+        if (index < 0 || !this.columns || !this.columns[index]) {
+            throw new Error(`No encoded column found: ${columnName}`);
         }
-
-        // Encode all rows
-        const encodedData = data.map(row => {
-            const encodedRow = {};
-            
-            for (const columnName of this.columnNames) {
-                const value = row[columnName];
-                
-                if (this.columnTypes[columnName] === 'categorical') {
-                    encodedRow[columnName] = this.encodeValue(columnName, value);
-                } else {
-                    // Numeric column - convert to number
-                    encodedRow[columnName] = Number(value);
-                }
-            }
-            
-            return encodedRow;
-        });
-
-        return encodedData;
+        return this.columns[index];
     }
 
     /**
-     * Builds encoding/decoding maps for a categorical column
-     * @private
-     * @param {string} columnName - Name of the column
-     * @param {Array<Object>} data - Complete dataset
+     * Interleaves encoded columns into one row-major matrix, ready for a
+     * single HEAPF32.set into the WASM heap
+     * @param {Array<string>} columnNames - Columns to include, in order
+     * @returns {Float32Array} Values laid out as [row][column]
      */
-    _buildEncodingMap(columnName, data) {
-        // Get unique values
-        const uniqueValues = new Set();
-        
-        for (const row of data) {
-            const value = row[columnName];
-            if (value !== null && value !== undefined && value !== '') {
-                uniqueValues.add(String(value));
+    getRowMajor(columnNames) {
+        const columns = columnNames.map(name => this.getColumn(name));
+        const n_cols = columns.length;
+        const n_rows = n_cols > 0 ? columns[0].length : 0;
+        const matrix = new Float32Array(n_rows * n_cols);
+        for (let c = 0; c < n_cols; c++) {
+            const column = columns[c];
+            for (let r = 0, i = c; r < n_rows; r++, i += n_cols) {
+                matrix[i] = column[r];
             }
         }
+        return matrix;
+    }
 
-        // Create encoding map (string -> number)
-        const encodingMap = {};
-        const decodingMap = {};
-        let code = 0;
-
-        // Sort unique values for consistent encoding
-        const sortedValues = Array.from(uniqueValues).sort();
-        
-        for (const value of sortedValues) {
-            encodingMap[value] = code;
-            decodingMap[code] = value;
-            code++;
+    /**
+     * Marks every column as numeric, for data parsed without string cells
+     * (the native CSV parser only accepts all-numeric files)
+     * @param {Array<string>} columnNames - Column names in order
+     */
+    setNumericColumns(columnNames) {
+        this.columnNames = [...columnNames];
+        this.columns = [];
+        this.columnTypes = {};
+        for (const columnName of this.columnNames) {
+            this.columnTypes[columnName] = 'numeric';
         }
-
-        this.encodingMaps[columnName] = encodingMap;
-        this.decodingMaps[columnName] = decodingMap;
     }
 
     /**
@@ -0,0 +1,143 @@
+/**
+ * TrainStream - Live training progress shared between the training worker and
+ * the page through one SharedArrayBuffer, so the page reads it without copies
+ * or messages (poll it from requestAnimationFrame).
+ *
+ * Layout: Int32 control words, then a ring of per-epoch records
+ * [epoch, loss, rows per second, elapsed ms] as Float32, then the current
+ * weights (the model's flat parameter block, as get_network_params).
+ * The worker is the only writer; the page only reads, except for the cancel
+ * flag.
+ */
+const STREAM_HEAD = 0;          // Records published so far (record i lives in slot i % capacity)
+const STREAM_CANCEL = 1;        // Set by the page to stop training after the current slice
+const STREAM_WEIGHTS_SEQ = 2;   // Weights sequence lock: odd while the worker is writing them
+const STREAM_CAPACITY = 3;      // Ring slots
+const STREAM_N_PARAMS = 4;      // Floats in the weights block
+const STREAM_CONTROL_WORDS = 8;
+const STREAM_RECORD_FLOATS = 4;
+
+class TrainStream {
+    /**
+     * Wraps an existing stream buffer (as created by TrainStream.create)
+     * @param {SharedArrayBuffer} buffer - Stream buffer
+     */
+    constructor(buffer) {
+        this.buffer = buffer;
+        this.control = new Int32Array(buffer, 0, STREAM_CONTROL_WORDS);
+        this.capacity = this.control[STREAM_CAPACITY];
+        this.nParams = this.control[STREAM_N_PARAMS];
+
+        const recordsOffset = STREAM_CONTROL_WORDS * 4;
+        const recordFloats = this.capacity * STREAM_RECORD_FLOATS;
+        this.records = new Float32Array(buffer, recordsOffset, recordFloats);
+        this.weights = new Float32Array(buffer, recordsOffset + recordFloats * 4, this.nParams);
+    }
+
+    /**
+     * Allocates a stream
+     * @param {number} capacity - Epoch records kept before the oldest is overwritten
+     * @param {number} nParams - Model parameter count
+     * @returns {TrainStream} Stream over a new SharedArrayBuffer
+     */
+    static create(capacity, nParams) {
+        const bytes = (STREAM_CONTROL_WORDS + capacity * STREAM_RECORD_FLOATS + nParams) * 4;
+        const buffer = new SharedArrayBuffer(bytes);
+        const control = new Int32Array(buffer, 0, STREAM_CONTROL_WORDS);
+        control[STREAM_CAPACITY] = capacity;
+        control[STREAM_N_PARAMS] = nParams;
+        return new TrainStream(buffer);
+    }
+
+    /**
+     * Worker: publishes one completed epoch
+     * @param {number} epoch - Epoch index
+     * @param {number} loss - Mean loss of the epoch
+     * @param {number} rowsPerSecond - Training throughput
+     * @param {number} elapsedMs - Time since training started
+     */
+    publishEpoch(epoch, loss, rowsPerSecond, elapsedMs) {
+        const head = this.control[STREAM_HEAD];
+        const slot = (head % this.capacity) * STREAM_RECORD_FLOATS;
+        this.records[slot] = epoch;
+        this.records[slot + 1] = loss;
+        this.records[slot + 2] = rowsPerSecond;
+        this.records[slot + 3] = elapsedMs;
+
+        // Publishing the new head makes the record visible to the page
+        Atomics.store(this.control, STREAM_HEAD, head + 1);
+    }
+
+    /**
+     * Worker: publishes the current weights
+     * @param {Float32Array} params - Flat parameter block (nParams floats)
+     */
+    publishWeights(params) {
+        Atomics.add(this.control, STREAM_WEIGHTS_SEQ, 1);
+        this.weights.set(params);
+        Atomics.add(this.control, STREAM_WEIGHTS_SEQ, 1);
+    }
+
+    /**
+     * Page: reads the records published since `next`. If the worker got more
+     * than `capacity - 1` records ahead, the overwritten ones are skipped, so
+     * onEpoch may see gaps but never a torn record.
+     * @param {number} next - Index of the first record not read yet
+     * @param {function(number, number, number, number)} onEpoch - Called with
+     *        (epoch, loss, rowsPerSecond, elapsedMs) for each record in order
+     * @returns {number} Index of the next record to read
+     */
+    readEpochs(next, onEpoch) {
+        const head = Atomics.load(this.control, STREAM_HEAD);
+        // Record head - capacity shares its slot with record head, which the worker may be writing
+        let index = Math.max(next, head - this.capacity + 1);
+        for (; index < head; index++) {
+            const slot = (index % this.capacity) * STREAM_RECORD_FLOATS;
+            const epoch = this.records[slot];
+            const loss = this.records[slot + 1];
+            const rowsPerSecond = this.records[slot + 2];
+            const elapsedMs = this.records[slot + 3];
+
+            // Drop the record if the worker reused its slot while it was read
+            if (Atomics.load(this.control, STREAM_HEAD) - index >= this.capacity) {
+                continue;
+            }
+            onEpoch(epoch, loss, rowsPerSecond, elapsedMs);
+        }
+        return index;
+    }
+
+    /**
+     * Page: copies the latest complete weights snapshot
+     * @param {Float32Array} out - Destination (nParams floats)
+     * @returns {boolean} False if the worker was writing them (try next frame)
+     */
+    readWeights(out) {
+        const seq = Atomics.load(this.control, STREAM_WEIGHTS_SEQ);
+        if (seq === 0 || (seq & 1) !== 0) {
+            return false;
+        }
+        out.set(this.weights);
+        return Atomics.load(this.control, STREAM_WEIGHTS_SEQ) === seq;
+    }
+
+    /**
+     * Page: asks the worker to stop after its current slice
+     */
+    cancel() {
+        Atomics.store(this.control, STREAM_CANCEL, 1);
+    }
+
+    /**
+     * Worker: checks for a cancel request
+     * @returns {boolean} True if the page asked to stop
+     */
+    isCancelled() {
+        return Atomics.load(this.control, STREAM_CANCEL) !== 0;
+    }
+}
+
+// Export for use in other modules
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = TrainStream;
+}
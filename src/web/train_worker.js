@@ -0,0 +1,125 @@
+/**
+ * Training worker: runs the resumable C training loop in its own WASM module
+ * instance, off the page's main thread. Progress goes out through a
+ * TrainStream (per-epoch loss and throughput, current weights); the trained
+ * model goes back as save_model bytes for the page to load.
+ *
+ * Messages in:  { type: 'train', inputs, outputs, config, buffer }
+ * Messages out: { type: 'ready' } or { type: 'unsupported' } once loaded,
+ *               { type: 'done', loss, epochs, model } or { type: 'error', code }
+ */
+importScripts('neurobrain.js', 'train_stream.js');
+
+// Training time between cancel checks and weight snapshots
+const WORKER_SLICE_MS = 50;
+
+let wasm = null;
+
+Module().then(module => {
+    if (typeof module._train_network_begin === 'undefined' || typeof module._save_model === 'undefined') {
+        postMessage({ type: 'unsupported' });
+        return;
+    }
+
+    wasm = {
+        begin: module.cwrap('train_network_begin', 'number', ['number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number', 'number']),
+        runForMs: module.cwrap('train_network_run_for_ms', 'number', ['number', 'number']),
+        finish: module.cwrap('train_network_finish', 'number', ['number']),
+        getParams: module.cwrap('get_network_params', 'number', ['number', 'number']),
+        save: module.cwrap('save_model', 'number', ['number', 'number', 'number']),
+        malloc: module._malloc,
+        free: module._free,
+        // Heap views are replaced when memory grows, so always read them from the module
+        get HEAPF32() { return module.HEAPF32; },
+        get HEAPU8() { return module.HEAPU8; }
+    };
+    postMessage({ type: 'ready' });
+});
+
+/**
+ * Trains the worker's default network and streams progress
+ * @param {Float32Array} inputs - Row-major normalized features
+ * @param {Float32Array} outputs - Targets (class codes for a classifier)
+ * @param {Object} config - n_rows, n_inputs, hiddenLayers, hiddenSize,
+ *        activationType, n_outputs, epochs
+ * @param {TrainStream} stream - Progress stream shared with the page
+ */
+function train(inputs, outputs, config, stream) {
+    const { n_rows, n_inputs, hiddenLayers, hiddenSize, activationType, n_outputs, epochs } = config;
+
+    const inputsPtr = wasm.malloc(inputs.length * 4);
+    const outputsPtr = wasm.malloc(outputs.length * 4);
+    const lossHistoryPtr = wasm.malloc(epochs * 4);
+    const layersPtr = wasm.malloc(hiddenLayers * 2 * 4);
+    const paramsPtr = wasm.malloc(stream.nParams * 4);
+
+    try {
+        wasm.HEAPF32.set(inputs, inputsPtr / 4);
+        wasm.HEAPF32.set(outputs, outputsPtr / 4);
+        const layerSpec = new Int32Array(wasm.HEAPU8.buffer, layersPtr, hiddenLayers * 2);
+        layerSpec.fill(hiddenSize, 0, hiddenLayers);
+        layerSpec.fill(activationType, hiddenLayers);
+
+        // Per-sample SGD (batch 1, learning rate 0.01) as the page's own training
+        const status = wasm.begin(0, inputsPtr, outputsPtr, n_rows, n_inputs, hiddenLayers,
+                                  layersPtr, layersPtr + hiddenLayers * 4, n_outputs,
+                                  1, 0, 0.01, epochs, lossHistoryPtr);
+        if (status < 0) {
+            postMessage({ type: 'error', code: status });
+            return;
+        }
+
+        // The page sized the weights block from the architecture; only stream matching snapshots
+        const streamWeights = wasm.getParams(0, 0) === stream.nParams;
+        const startTime = performance.now();
+        let epochTime = startTime;
+        let published = 0;
+        while (published < epochs && !stream.isCancelled()) {
+            const completed = wasm.runForMs(0, WORKER_SLICE_MS);
+            if (completed < 0) {
+                break;
+            }
+            if (completed === published) {
+                continue;
+            }
+
+            // Throughput over the epochs finished in this slice (early stopping
+            // completes the remaining epochs at once with the final loss)
+            const now = performance.now();
+            const rowsPerSecond = n_rows * (completed - published) / Math.max(now - epochTime, 1e-3) * 1000;
+            epochTime = now;
+
+            const lossHistory = new Float32Array(wasm.HEAPF32.buffer, lossHistoryPtr, epochs);
+            for (; published < completed; published++) {
+                stream.publishEpoch(published, lossHistory[published], rowsPerSecond, now - startTime);
+            }
+
+            if (streamWeights) {
+                wasm.getParams(0, paramsPtr);
+                stream.publishWeights(new Float32Array(wasm.HEAPF32.buffer, paramsPtr, stream.nParams));
+            }
+        }
+
+        // The trained (or cancelled) model goes back to the page as save_model bytes
+        const loss = wasm.finish(0);
+        const size = wasm.save(0, 0, 0);
+        const modelPtr = wasm.malloc(size);
+        wasm.save(0, modelPtr, size);
+        const model = wasm.HEAPU8.slice(modelPtr, modelPtr + size).buffer;
+        wasm.free(modelPtr);
+        postMessage({ type: 'done', loss, epochs: published, model }, [model]);
+    } finally {
+        wasm.free(inputsPtr);
+        wasm.free(outputsPtr);
+        wasm.free(lossHistoryPtr);
+        wasm.free(layersPtr);
+        wasm.free(paramsPtr);
+    }
+}
+
+onmessage = function(e) {
+    const message = e.data;
+    if (message.type === 'train') {
+        train(message.inputs, message.outputs, message.config, new TrainStream(message.buffer));
+    }
+};